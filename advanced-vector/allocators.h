@@ -0,0 +1,578 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "segment_layout.h"
+#include "vector.h"
+
+// Аллокатор поверх malloc/free. В отличие от std::allocator умеет расширять буфер через realloc,
+// что позволяет Vector растить буфер тривиально перемещаемых элементов без копирования.
+// Для больших блоков glibc выделяет память через mmap и расширяет её через mremap,
+// поэтому рост не требует временной второй копии буфера
+template <typename T>
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator does not support over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        std::free(p);
+    }
+
+    // При неудаче realloc старый блок остаётся действительным
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        if (new_n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* new_p = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        if (new_p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_p);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+// Аллокатор буферов, выровненных по Alignment байт (по умолчанию — строка кэша и регистр AVX-512).
+// Ёмкость округляется вверх до целого числа блоков по Alignment байт, поэтому SIMD-цикл может
+// обработать хвост полным регистром без скалярного остатка: память за последним элементом
+// до конца блока принадлежит буферу
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        if (n > (static_cast<size_t>(-1) - Alignment) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = (n * sizeof(T) + Alignment - 1) & ~(Alignment - 1);
+        void* p = operator new(bytes, std::align_val_t{Alignment});
+        return {static_cast<T*>(p), bytes / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return false;
+    }
+};
+
+// Пул освобождённых буферов, разбитых на классы размера — степени двойки от MIN_BLOCK байт.
+// Освобождённый блок кладётся в список своего класса, и следующее выделение того же класса забирает его
+// без обращения к operator new, поэтому векторы одинаковой формы, которые постоянно создаются и
+// уничтожаются, переиспользуют одни и те же буферы. Пул хранит не больше max_cached_bytes байт,
+// лишние и более крупные блоки возвращаются в operator delete. Пул не потокобезопасен:
+// каждый поток по умолчанию пользуется своим (ThreadLocal)
+class BufferPool {
+public:
+    static constexpr size_t MIN_BLOCK = 16;
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = size_t{16} << 20;
+
+    explicit BufferPool(size_t max_cached_bytes = DEFAULT_MAX_CACHED_BYTES) noexcept
+        : max_cached_bytes_(max_cached_bytes) {
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool() {
+        Trim();
+    }
+
+    // Размер блока, который выделяется под bytes байт (bytes <= SIZE_MAX / 2)
+    static size_t BlockSize(size_t bytes) noexcept {
+        return bytes <= MIN_BLOCK ? MIN_BLOCK : size_t{2} << detail::Log2(bytes - 1);
+    }
+
+    // Выделяет блок размера block_size (результат BlockSize), по возможности из кэша
+    void* Allocate(size_t block_size) {
+        const size_t index = ClassIndex(block_size);
+        if (free_[index] != nullptr) {
+            FreeBlock* block = free_[index];
+            free_[index] = block->next;
+            cached_bytes_ -= block_size;
+            return block;
+        }
+        return operator new(block_size);
+    }
+
+    void Deallocate(void* p, size_t block_size) noexcept {
+        const size_t index = ClassIndex(block_size);
+        if (block_size > max_cached_bytes_ - cached_bytes_) {
+            operator delete(p);
+            return;
+        }
+        free_[index] = new (p) FreeBlock{free_[index]};
+        cached_bytes_ += block_size;
+    }
+
+    // Возвращает все закэшированные блоки в operator delete
+    void Trim() noexcept {
+        for (FreeBlock*& head : free_) {
+            while (head != nullptr) {
+                operator delete(std::exchange(head, head->next));
+            }
+        }
+        cached_bytes_ = 0;
+    }
+
+    size_t CachedBytes() const noexcept {
+        return cached_bytes_;
+    }
+
+    // Пул текущего потока или nullptr, если поток уже завершается и его пул разрушен
+    static BufferPool* ThreadLocal() noexcept;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static_assert(sizeof(FreeBlock) <= MIN_BLOCK);
+
+    static constexpr size_t CLASS_COUNT = std::numeric_limits<size_t>::digits;
+
+    static size_t ClassIndex(size_t block_size) noexcept {
+        return detail::Log2(block_size) - detail::Log2(MIN_BLOCK);
+    }
+
+    struct ThreadLocalOwner;
+
+    // Указатель на пул потока тривиально разрушаем, поэтому его можно читать и после разрушения
+    // самого пула: векторы, уничтоженные позже, освобождают память напрямую
+    static inline thread_local BufferPool* tls_pool_ = nullptr;
+    static inline thread_local bool tls_pool_destroyed_ = false;
+
+    FreeBlock* free_[CLASS_COUNT] = {};
+    size_t cached_bytes_ = 0;
+    size_t max_cached_bytes_;
+};
+
+struct BufferPool::ThreadLocalOwner {
+    ThreadLocalOwner() noexcept {
+        tls_pool_ = &pool;
+    }
+
+    ~ThreadLocalOwner() {
+        tls_pool_ = nullptr;
+        tls_pool_destroyed_ = true;
+    }
+
+    BufferPool pool;
+};
+
+inline BufferPool* BufferPool::ThreadLocal() noexcept {
+    if (tls_pool_ == nullptr && !tls_pool_destroyed_) {
+        thread_local ThreadLocalOwner owner;
+    }
+    return tls_pool_;
+}
+
+// Аллокатор, переиспользующий освобождённые буферы через BufferPool. По умолчанию используется пул
+// текущего потока, можно передать собственный пул (он должен пережить аллокатор и его копии и не
+// использоваться из разных потоков одновременно). Ёмкость округляется до класса размера пула, поэтому
+// вектор сразу получает всю память блока. Все блоки выделяются operator new, поэтому любой PoolAllocator
+// может освободить память, выделенную другим: блок просто попадёт в другой пул
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "PoolAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() = default;
+
+    explicit PoolAllocator(BufferPool& pool) noexcept
+        : pool_(&pool) {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+        : pool_(other.pool_) {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / 2 / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t block_size = BufferPool::BlockSize(n * sizeof(T));
+        BufferPool* pool = Pool();
+        void* p = pool != nullptr ? pool->Allocate(block_size) : operator new(block_size);
+        return {static_cast<T*>(p), block_size / sizeof(T)};
+    }
+
+    // n — запрошенное или полученное от allocate_at_least число элементов: оба дают один класс размера
+    void deallocate(T* p, size_t n) noexcept {
+        BufferPool* pool = Pool();
+        if (pool != nullptr) {
+            pool->Deallocate(p, BufferPool::BlockSize(n * sizeof(T)));
+        } else {
+            operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+
+private:
+    template <typename U>
+    friend class PoolAllocator;
+
+    BufferPool* Pool() const noexcept {
+        return pool_ != nullptr ? pool_ : BufferPool::ThreadLocal();
+    }
+
+    BufferPool* pool_ = nullptr;
+};
+
+#if defined(__linux__)
+
+namespace detail {
+
+inline size_t PageSize() noexcept {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+// Размер отображения под n элементов размера elem_size, округлённый вверх до целого числа страниц
+inline size_t MappingSize(size_t n, size_t elem_size) {
+    if (n > (static_cast<size_t>(-1) - PageSize()) / elem_size) {
+        throw std::bad_array_new_length();
+    }
+    const size_t page_size = PageSize();
+    return (n * elem_size + page_size - 1) / page_size * page_size;
+}
+
+// Отображает bytes байт анонимной памяти. Страницы выделяются ядром при первом обращении
+inline void* MapAnonymous(size_t bytes) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// Изменяет размер отображения, при необходимости перенося его по другому адресу без копирования страниц.
+// При неудаче старое отображение остаётся действительным
+inline void* RemapAnonymous(void* p, size_t old_bytes, size_t new_bytes) {
+    void* new_p = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+    if (new_p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return new_p;
+}
+
+// Отображает bytes байт анонимной памяти с адреса, кратного alignment (степени двойки, кратной странице).
+// Отображение с PROT_NONE только занимает участок адресного пространства
+inline void* MapAligned(size_t bytes, size_t alignment, int protection = PROT_READ | PROT_WRITE) {
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | (protection == PROT_NONE ? MAP_NORESERVE : 0);
+    void* mapping = mmap(nullptr, bytes + alignment, protection, flags, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    char* p = static_cast<char*>(mapping);
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(alignment - 1));
+    if (aligned != p) {
+        munmap(p, aligned - p);
+    }
+    munmap(aligned + bytes, p + alignment - aligned);
+    return aligned;
+}
+
+// Отображает bytes байт (кратно huge_page_size) огромными страницами. Сначала используется пул hugetlbfs
+// (MAP_HUGETLB); если он пуст или не настроен, память отображается обычными страницами с выравниванием
+// по огромной странице и помечается для прозрачных огромных страниц (MADV_HUGEPAGE)
+inline void* MapHugePages(size_t bytes, size_t huge_page_size) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        return p;
+    }
+    p = MapAligned(bytes, huge_page_size);
+    madvise(p, bytes, MADV_HUGEPAGE);  // без поддержки THP память остаётся на обычных страницах
+    return p;
+}
+
+// Изменяет размер отображения огромных страниц, сохраняя выравнивание адреса по огромной странице
+inline void* RemapHugePages(void* p, size_t old_bytes, size_t new_bytes, size_t huge_page_size) {
+    if (mremap(p, old_bytes, new_bytes, 0) != MAP_FAILED) {
+        return p;  // отображение изменилось на месте
+    }
+    // Отображение переносится в заранее занятый выровненный участок адресного пространства
+    void* target = MapAligned(new_bytes, huge_page_size, PROT_NONE);
+    void* new_p = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+    if (new_p == MAP_FAILED) {
+        munmap(target, new_bytes);
+        throw std::bad_alloc();
+    }
+    madvise(new_p, new_bytes, MADV_HUGEPAGE);
+    return new_p;
+}
+
+}  // namespace detail
+
+// Размещение страниц буфера по узлам NUMA
+enum class NumaPlacement {
+    FIRST_TOUCH,  // страница попадает на узел потока, первым обратившегося к ней
+    INTERLEAVE,   // страницы распределяются по узлам по кругу
+    BIND,         // страницы размещаются только на заданных узлах
+};
+
+// Аллокатор больших буферов с управляемым размещением страниц по узлам NUMA. Буфер отображается через mmap,
+// и страницы выделяются ядром при первом обращении:
+// - INTERLEAVE и BIND задают политику размещения через mbind, и она действует, какой бы поток ни обратился к странице;
+// - FIRST_TOUCH рассчитан на многопоточные операции: в Vector(n, parallel) и Reserve(n, parallel) каждый поток
+//   первым касается своей части буфера, и её страницы оказываются на узле этого потока.
+// Аллокатор передаётся вместе с содержимым вектора (propagate_on_container_*), поэтому Reserve, копирование
+// и присваивание размещают новый буфер так же. Тривиально перемещаемые элементы растут через mremap,
+// который переносит уже размещённые страницы без копирования.
+// Ёмкость округляется до целого числа страниц, поэтому аллокатор не подходит для маленьких векторов.
+// На ядрах без NUMA (ENOSYS) и для недоступных узлов mbind не действует, и страницы размещаются как обычно
+template <typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // Маска из всех узлов; ядро оставляет из неё узлы, доступные процессу
+    static constexpr unsigned long ALL_NODES = ~0UL;
+
+    explicit NumaAllocator(NumaPlacement placement = NumaPlacement::FIRST_TOUCH, unsigned long nodes = ALL_NODES) noexcept
+        : placement_(placement)
+        , nodes_(nodes) {
+    }
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>& other) noexcept
+        : placement_(other.GetPlacement())
+        , nodes_(other.GetNodes()) {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        const size_t bytes = detail::MappingSize(n, sizeof(T));
+        void* p = detail::MapAnonymous(bytes);
+        Place(p, bytes);
+        return {static_cast<T*>(p), bytes / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(static_cast<void*>(p), detail::MappingSize(n, sizeof(T)));
+    }
+
+    // mremap сохраняет политику размещения отображения, а перенесённые страницы остаются на своих узлах
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        const size_t old_bytes = detail::MappingSize(old_n, sizeof(T));
+        const size_t new_bytes = detail::MappingSize(new_n, sizeof(T));
+        if (old_bytes == new_bytes) {
+            return p;
+        }
+        return static_cast<T*>(detail::RemapAnonymous(static_cast<void*>(p), old_bytes, new_bytes));
+    }
+
+    NumaPlacement GetPlacement() const noexcept {
+        return placement_;
+    }
+
+    unsigned long GetNodes() const noexcept {
+        return nodes_;
+    }
+
+    // Освободить буфер может любой экземпляр, но аллокаторы с разным размещением считаются разными,
+    // чтобы присваивание не оставляло элементы в буфере, размещённом по чужой политике
+    template <typename U>
+    bool operator==(const NumaAllocator<U>& other) const noexcept {
+        return placement_ == other.GetPlacement() && nodes_ == other.GetNodes();
+    }
+
+    template <typename U>
+    bool operator!=(const NumaAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    void Place(void* p, size_t bytes) const noexcept {
+        if (placement_ == NumaPlacement::FIRST_TOUCH) {
+            return;
+        }
+        const int mode = placement_ == NumaPlacement::INTERLEAVE ? MPOL_INTERLEAVE : MPOL_BIND;
+        // Ядро читает maxnode - 1 бит маски
+        syscall(SYS_mbind, p, bytes, mode, &nodes_, sizeof(nodes_) * 8 + 1, 0);
+    }
+
+    NumaPlacement placement_;
+    unsigned long nodes_;
+};
+
+// Аллокатор, размещающий большие буферы на огромных страницах (2 МиБ), чтобы сократить промахи TLB
+// при произвольном доступе. Буферы от Threshold байт отображаются через mmap с MAP_HUGETLB, а если пул
+// огромных страниц недоступен — с выравниванием по огромной странице и MADV_HUGEPAGE; буферы меньше
+// порога выделяются через operator new. Ёмкость больших буферов округляется до целого числа огромных страниц,
+// и вся округлённая память доступна вектору. Тривиально перемещаемые элементы растут через reallocate:
+// отображение расширяется mremap без копирования и остаётся на огромных страницах
+template <typename T, size_t Threshold = size_t{2} << 20>
+struct HugePageAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "HugePageAllocator does not support over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Threshold>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Threshold>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        if (n > (static_cast<size_t>(-1) - HUGE_PAGE_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (!IsHuge(n)) {
+            return {static_cast<T*>(operator new(n * sizeof(T))), n};
+        }
+        const size_t bytes = HugeMappingSize(n);
+        return {static_cast<T*>(detail::MapHugePages(bytes, HUGE_PAGE_SIZE)), bytes / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (IsHuge(n)) {
+            munmap(static_cast<void*>(p), HugeMappingSize(n));
+        } else {
+            operator delete(static_cast<void*>(p));
+        }
+    }
+
+    // Ёмкость нового буфера округляется так же, как в allocate_at_least. При неудаче старый буфер остаётся действительным
+    AllocationResult<T> reallocate(T* p, size_t old_n, size_t new_n) {
+        if (IsHuge(old_n) && IsHuge(new_n)) {
+            const size_t bytes = HugeMappingSize(new_n);
+            try {
+                void* new_p = detail::RemapHugePages(static_cast<void*>(p), HugeMappingSize(old_n), bytes,
+                                                     HUGE_PAGE_SIZE);
+                return {static_cast<T*>(new_p), bytes / sizeof(T)};
+            } catch (const std::bad_alloc&) {
+                // Отображения из пула hugetlbfs могут не поддерживать mremap — буфер копируется
+            }
+        }
+        const AllocationResult<T> result = allocate_at_least(new_n);
+        std::memcpy(static_cast<void*>(result.ptr), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return result;
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, Threshold>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U, Threshold>&) const noexcept {
+        return false;
+    }
+
+private:
+    static bool IsHuge(size_t n) noexcept {
+        return n >= (Threshold + sizeof(T) - 1) / sizeof(T);
+    }
+
+    static size_t HugeMappingSize(size_t n) noexcept {
+        return (n * sizeof(T) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+};
+
+#endif
@@ -0,0 +1,374 @@
+// Сравнение производительности Vector и std::vector на Google Benchmark.
+// Сборка: g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -lbenchmark -pthread -o vector_benchmark
+//
+// Для каждой операции выводится время на итерацию и счётчик bytes/op — объём памяти,
+// выделенной контейнером за итерацию (через общий для обоих контейнеров считающий аллокатор)
+#include "allocators.h"
+#include "flat_set.h"
+#include "test_harness.h"
+#include "vector.h"
+#include "vector_parallel.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Pod64 {
+    uint64_t data[8];
+};
+
+// Копируемый тип, перемещение которого может выбросить исключение: при росте Vector вынужден копировать
+struct ThrowingMove {
+    ThrowingMove() = default;
+    explicit ThrowingMove(int id)
+        : id(id) {
+    }
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : id(other.id) {
+    }
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    ThrowingMove& operator=(ThrowingMove&& other) noexcept(false) {
+        id = other.id;
+        return *this;
+    }
+
+    int id = 0;
+    std::string payload = "payload that does not fit into SSO buffer";
+};
+
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return Pod64{{i, i, i, i, i, i, i, i}};
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return "string number " + std::to_string(i) + " that does not fit into SSO";
+    } else {
+        return T(static_cast<int>(i));
+    }
+}
+
+// Единый интерфейс для сравниваемых контейнеров
+template <typename T>
+struct AdvancedVector {
+    using Container = Vector<T, CountingAllocator<T>>;
+
+    static void PushBack(Container& c, const T& value) {
+        c.PushBack(value);
+    }
+    template <typename... Args>
+    static void EmplaceBack(Container& c, Args&&... args) {
+        c.EmplaceBack(std::forward<Args>(args)...);
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.Reserve(n);
+    }
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.Insert(c.begin() + index, value);
+    }
+    static void Erase(Container& c, size_t index) {
+        c.Erase(c.begin() + index);
+    }
+};
+
+template <typename T>
+struct StdVector {
+    using Container = std::vector<T, CountingAllocator<T>>;
+
+    static void PushBack(Container& c, const T& value) {
+        c.push_back(value);
+    }
+    template <typename... Args>
+    static void EmplaceBack(Container& c, Args&&... args) {
+        c.emplace_back(std::forward<Args>(args)...);
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.reserve(n);
+    }
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.insert(c.begin() + index, value);
+    }
+    static void Erase(Container& c, size_t index) {
+        c.erase(c.begin() + index);
+    }
+};
+
+template <typename Ops>
+typename Ops::Container MakeContainer(size_t n) {
+    using T = std::decay_t<decltype(*std::declval<typename Ops::Container&>().begin())>;
+    typename Ops::Container c;
+    Ops::Reserve(c, n);
+    for (size_t i = 0; i < n; ++i) {
+        Ops::PushBack(c, MakeValue<T>(i));
+    }
+    return c;
+}
+
+// Делит выделенную за замер память на число итераций
+void ReportBytes(benchmark::State& state, size_t bytes_before) {
+    const size_t bytes = harness_counters.allocated_bytes - bytes_before;
+    state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+
+template <template <typename> typename Ops, typename T>
+void BM_PushBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const T value = MakeValue<T>(1);
+    const size_t bytes_before = harness_counters.allocated_bytes;
+    for (auto _ : state) {
+        typename Ops<T>::Container c;
+        for (size_t i = 0; i < n; ++i) {
+            Ops<T>::PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c.begin());
+    }
+    ReportBytes(state, bytes_before);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <template <typename> typename Ops, typename T>
+void BM_EmplaceBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const size_t bytes_before = harness_counters.allocated_bytes;
+    for (auto _ : state) {
+        typename Ops<T>::Container c;
+        for (size_t i = 0; i < n; ++i) {
+            Ops<T>::EmplaceBack(c, MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(c.begin());
+    }
+    ReportBytes(state, bytes_before);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <template <typename> typename Ops, typename T>
+void BM_ReserveThenPushBack(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const T value = MakeValue<T>(1);
+    const size_t bytes_before = harness_counters.allocated_bytes;
+    for (auto _ : state) {
+        typename Ops<T>::Container c;
+        Ops<T>::Reserve(c, n);
+        for (size_t i = 0; i < n; ++i) {
+            Ops<T>::PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c.begin());
+    }
+    ReportBytes(state, bytes_before);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+enum class Position { FRONT, MIDDLE, BACK };
+
+size_t IndexAt(Position position, size_t size) {
+    switch (position) {
+        case Position::FRONT:
+            return 0;
+        case Position::MIDDLE:
+            return size / 2;
+        default:
+            return size;
+    }
+}
+
+// Вставка и удаление одного элемента в контейнере постоянного размера
+template <template <typename> typename Ops, typename T, Position Pos>
+void BM_InsertErase(benchmark::State& state) {
+    const size_t n = state.range(0);
+    auto c = MakeContainer<Ops<T>>(n);
+    Ops<T>::Reserve(c, n + 1);
+    const T value = MakeValue<T>(0);
+    const size_t bytes_before = harness_counters.allocated_bytes;
+    for (auto _ : state) {
+        const size_t index = IndexAt(Pos, n);
+        Ops<T>::Insert(c, index, value);
+        Ops<T>::Erase(c, index);
+        benchmark::DoNotOptimize(c.begin());
+    }
+    ReportBytes(state, bytes_before);
+}
+
+// Копирующее присваивание в контейнер достаточной ёмкости (Vector::CopyAssignNoRealloc)
+template <template <typename> typename Ops, typename T>
+void BM_CopyAssignNoRealloc(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const auto source = MakeContainer<Ops<T>>(n);
+    auto target = MakeContainer<Ops<T>>(n * 2);
+    const size_t bytes_before = harness_counters.allocated_bytes;
+    for (auto _ : state) {
+        target = source;
+        benchmark::DoNotOptimize(target.begin());
+        benchmark::ClobberMemory();
+    }
+    ReportBytes(state, bytes_before);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <template <typename> typename Ops, typename T>
+void BM_Iterate(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const auto c = MakeContainer<Ops<T>>(n);
+    for (auto _ : state) {
+        for (const T& value : c) {
+            benchmark::DoNotOptimize(&value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Создание, копирование и разрушение большого вектора строк в одном потоке и по политике parallel
+template <bool Parallel>
+void BM_LargeLifecycle(benchmark::State& state) {
+    using Container = AdvancedVector<std::string>::Container;
+    const size_t n = state.range(0);
+    const auto source = MakeContainer<AdvancedVector<std::string>>(n);
+    for (auto _ : state) {
+        if constexpr (Parallel) {
+            Container created(n, parallel);
+            Container copy(source, parallel);
+            benchmark::DoNotOptimize(copy.begin());
+            created.Clear(parallel);
+            copy.Clear(parallel);
+        } else {
+            Container created(n);
+            Container copy(source);
+            benchmark::DoNotOptimize(copy.begin());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Создание, заполнение и разрушение вектора одной формы, как в цикле обработки запросов
+template <typename Alloc>
+void BM_CreateDestroy(benchmark::State& state) {
+    const size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector<uint64_t, Alloc> v;
+        v.Reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            v.PushBack(i);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+enum class Append { EMPLACE_BACK, SINK, ACQUIRE };
+
+// Заполнение вектора n числами без предварительного резервирования: поштучно, через AppendSink и через Acquire
+template <Append Kind>
+void BM_Append(benchmark::State& state) {
+    const size_t n = state.range(0);
+    for (auto _ : state) {
+        Vector<uint64_t> v;
+        if constexpr (Kind == Append::EMPLACE_BACK) {
+            for (size_t i = 0; i < n; ++i) {
+                v.EmplaceBack(i * 3);
+            }
+        } else if constexpr (Kind == Append::SINK) {
+            auto sink = v.BackInserter();
+            for (size_t i = 0; i < n; ++i) {
+                sink.EmplaceBack(i * 3);
+            }
+            sink.Commit();
+        } else {
+            auto sink = v.BackInserter();
+            uint64_t* out = sink.Acquire(n);
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = i * 3;
+            }
+            sink.Produced(n);
+            sink.Commit();
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+enum class Lookup { STD_SET, STD_LOWER_BOUND, FLAT_SET, EYTZINGER };
+
+// Поиск случайных ключей (половина из них отсутствует) в наборе из n ключей
+template <Lookup Kind>
+void BM_Lookup(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::mt19937_64 random(42);
+    Vector<uint64_t> keys;
+    for (size_t i = 0; i < n; ++i) {
+        keys.PushBack(random() & ~uint64_t{1});
+    }
+    const FlatSet<uint64_t> flat(keys.begin(), keys.end());
+    const std::set<uint64_t> tree(keys.begin(), keys.end());
+    const auto snapshot = flat.MakeSnapshot();
+    Vector<uint64_t> queries;
+    for (size_t i = 0; i < 1 << 16; ++i) {
+        queries.PushBack(keys[random() % n] | (random() & 1));
+    }
+    size_t found = 0;
+    for (auto _ : state) {
+        for (uint64_t key : queries) {
+            if constexpr (Kind == Lookup::STD_SET) {
+                found += tree.count(key);
+            } else if constexpr (Kind == Lookup::STD_LOWER_BOUND) {
+                const uint64_t* it = std::lower_bound(flat.begin(), flat.end(), key);
+                found += it != flat.end() && *it == key;
+            } else if constexpr (Kind == Lookup::FLAT_SET) {
+                found += flat.Contains(key);
+            } else {
+                found += snapshot.Contains(key);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations() * queries.Size());
+}
+
+}  // namespace
+
+#define VECTOR_BENCHMARKS(T)                                                                    \
+    BENCHMARK_TEMPLATE(BM_PushBackGrowth, AdvancedVector, T)->Range(8, 1 << 16);               \
+    BENCHMARK_TEMPLATE(BM_PushBackGrowth, StdVector, T)->Range(8, 1 << 16);                    \
+    BENCHMARK_TEMPLATE(BM_EmplaceBackGrowth, AdvancedVector, T)->Range(8, 1 << 16);            \
+    BENCHMARK_TEMPLATE(BM_EmplaceBackGrowth, StdVector, T)->Range(8, 1 << 16);                 \
+    BENCHMARK_TEMPLATE(BM_ReserveThenPushBack, AdvancedVector, T)->Range(8, 1 << 16);          \
+    BENCHMARK_TEMPLATE(BM_ReserveThenPushBack, StdVector, T)->Range(8, 1 << 16);               \
+    BENCHMARK_TEMPLATE(BM_InsertErase, AdvancedVector, T, Position::FRONT)->Range(64, 1 << 14);  \
+    BENCHMARK_TEMPLATE(BM_InsertErase, StdVector, T, Position::FRONT)->Range(64, 1 << 14);       \
+    BENCHMARK_TEMPLATE(BM_InsertErase, AdvancedVector, T, Position::MIDDLE)->Range(64, 1 << 14); \
+    BENCHMARK_TEMPLATE(BM_InsertErase, StdVector, T, Position::MIDDLE)->Range(64, 1 << 14);      \
+    BENCHMARK_TEMPLATE(BM_InsertErase, AdvancedVector, T, Position::BACK)->Range(64, 1 << 14);   \
+    BENCHMARK_TEMPLATE(BM_InsertErase, StdVector, T, Position::BACK)->Range(64, 1 << 14);        \
+    BENCHMARK_TEMPLATE(BM_CopyAssignNoRealloc, AdvancedVector, T)->Range(8, 1 << 14);          \
+    BENCHMARK_TEMPLATE(BM_CopyAssignNoRealloc, StdVector, T)->Range(8, 1 << 14);               \
+    BENCHMARK_TEMPLATE(BM_Iterate, AdvancedVector, T)->Range(8, 1 << 16);                      \
+    BENCHMARK_TEMPLATE(BM_Iterate, StdVector, T)->Range(8, 1 << 16)
+
+VECTOR_BENCHMARKS(int);
+VECTOR_BENCHMARKS(Pod64);
+VECTOR_BENCHMARKS(std::string);
+VECTOR_BENCHMARKS(ThrowingMove);
+
+BENCHMARK_TEMPLATE(BM_LargeLifecycle, false)->Arg(1 << 22)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LargeLifecycle, true)->Arg(1 << 22)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_CreateDestroy, std::allocator<uint64_t>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_CreateDestroy, PoolAllocator<uint64_t>)->Range(8, 1 << 16);
+
+BENCHMARK_TEMPLATE(BM_Append, Append::EMPLACE_BACK)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Append, Append::SINK)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Append, Append::ACQUIRE)->Range(8, 1 << 16);
+
+BENCHMARK_TEMPLATE(BM_Lookup, Lookup::STD_SET)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, Lookup::STD_LOWER_BOUND)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, Lookup::FLAT_SET)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, Lookup::EYTZINGER)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
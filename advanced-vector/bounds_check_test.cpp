@@ -0,0 +1,71 @@
+// Проверка режимов ADVANCED_VECTOR_BOUNDS_TRAP и ADVANCED_VECTOR_BOUNDS_OFF. Режим задаётся на всю единицу
+// трансляции, поэтому каждый собирается отдельно, с NDEBUG, чтобы assert не подменял проверку режима:
+// g++ -std=c++17 -DNDEBUG -DADVANCED_VECTOR_BOUNDS_CHECK=ADVANCED_VECTOR_BOUNDS_TRAP bounds_check_test.cpp -o bounds_trap
+// g++ -std=c++17 -DNDEBUG -DADVANCED_VECTOR_BOUNDS_CHECK=ADVANCED_VECTOR_BOUNDS_OFF bounds_check_test.cpp -o bounds_off
+// Режим ADVANCED_VECTOR_BOUNDS_ASSERT (по умолчанию) проверяется тестами main.cpp
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "vector.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if !defined(ADVANCED_VECTOR_BOUNDS_CHECK) || ADVANCED_VECTOR_BOUNDS_CHECK == ADVANCED_VECTOR_BOUNDS_ASSERT
+#error "Build with -DADVANCED_VECTOR_BOUNDS_CHECK=ADVANCED_VECTOR_BOUNDS_TRAP or ADVANCED_VECTOR_BOUNDS_OFF"
+#endif
+
+namespace {
+
+// assert отключён NDEBUG, поэтому условия проверяются явно
+void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "Check failed: " << what << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+// Выполняет action в дочернем процессе и возвращает, завершился ли он по сигналу
+template <typename Action>
+bool KilledBySignal(Action action) {
+    const pid_t pid = fork();
+    Check(pid >= 0, "fork");
+    if (pid == 0) {
+        action();
+        _exit(EXIT_SUCCESS);
+    }
+    int status = 0;
+    Check(waitpid(pid, &status, 0) == pid, "waitpid");
+    return WIFSIGNALED(status);
+}
+
+}  // namespace
+
+int main() {
+    Vector<int> v(3);
+    v[2] = 7;
+    const Vector<int>& cv = v;
+    Check(v[2] == 7 && cv[2] == 7, "in-range Vector access");
+    SmallVector<int, 4> small(2);
+    small[1] = 5;
+    Check(small[1] == 5, "in-range SmallVector access");
+    SegmentedVector<int> segmented(3);
+    segmented[2] = 9;
+    Check(segmented[2] == 9, "in-range SegmentedVector access");
+
+    // Индекс за концом, но в пределах ёмкости: без проверки обращение не выходит за буфер
+    v.Reserve(8);
+#if ADVANCED_VECTOR_BOUNDS_CHECK == ADVANCED_VECTOR_BOUNDS_TRAP
+    Check(KilledBySignal([&] { v[3] = 1; }), "TRAP mode stops on Vector index past the end");
+    Check(KilledBySignal([&] { small[2] = 1; }), "TRAP mode stops on SmallVector index past the end");
+    Check(KilledBySignal([&] { segmented[3] = 1; }), "TRAP mode stops on SegmentedVector index past the end");
+    Check(!KilledBySignal([&] { v[2] = 1; }), "TRAP mode allows in-range index");
+    std::cout << "Bounds TRAP mode: all tests passed" << std::endl;
+#else
+    Check(!KilledBySignal([] { ADVANCED_VECTOR_CHECK_BOUNDS(false); }), "OFF mode does not check");
+    Check(!KilledBySignal([&] { v[3] = 1; }), "OFF mode allows index past the end");
+    std::cout << "Bounds OFF mode: all tests passed" << std::endl;
+#endif
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "segment_layout.h"
+#include "vector.h"
+
+// Вектор с неблокирующим добавлением из многих потоков. Каждый EmplaceBack атомарно резервирует индекс
+// и создаёт элемент в сегменте; сегменты растут геометрически и никогда не перемещаются, поэтому ссылки
+// на элементы остаются действительными. Первый поток, которому понадобился сегмент, выделяет его
+// и публикует через compare_exchange; проигравшие гонку освобождают свои копии.
+// Чтение из других потоков во время добавления допустимо для элементов, готовность которых
+// подтверждена IsReady. Когда добавление закончено, Compact переносит элементы в обычный Vector.
+// Если конструктор элемента выбросил исключение, его ячейка остаётся пустой и пропускается
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegment = 64>
+class ConcurrentVector {
+    using Layout = detail::SegmentLayout<FirstSegment>;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<bool> ready{false};
+
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        const T* Get() const noexcept {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using SlotAllocTraits = std::allocator_traits<SlotAlloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+    }
+
+    // Потокобезопасно добавляет элемент и возвращает ссылку на него
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        const size_t segment = Layout::SegmentOf(index);
+        const size_t offset = index - Layout::SegmentStart(segment);
+        Slot& slot = GetOrAllocateSegment(segment)[offset];
+        if (offset == Layout::SegmentSize(segment) / 2 && segment + 1 < Layout::MAX_SEGMENTS) {
+            // Следующий сегмент выделяется заранее, чтобы потоки не соревновались за него на границе.
+            // Если памяти не хватило, сегмент выделит первый поток, которому он понадобится
+            try {
+                GetOrAllocateSegment(segment + 1);
+            } catch (const std::bad_alloc&) {
+            }
+        }
+        T* item = new (slot.storage) T(std::forward<Args>(args)...);
+        slot.ready.store(true, std::memory_order_release);
+        return *item;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Число зарезервированных индексов. Элементы с индексами меньше Size() могут быть ещё не созданы
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Элемент с индексом index создан и доступен для чтения
+    bool IsReady(size_t index) const noexcept {
+        if (index >= Size()) {
+            return false;
+        }
+        const size_t segment = Layout::SegmentOf(index);
+        const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots != nullptr
+            && slots[index - Layout::SegmentStart(segment)].ready.load(std::memory_order_acquire);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(IsReady(index));
+        return *GetSlot(index).Get();
+    }
+
+    T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(IsReady(index));
+        return *GetSlot(index).Get();
+    }
+
+    // Переносит созданные элементы в порядке индексов в обычный Vector и очищает ConcurrentVector.
+    // Вызывается, когда добавление из других потоков завершено. Если перенос выбрасывает исключение,
+    // ConcurrentVector остаётся неизменным
+    Vector<T, Alloc> Compact() {
+        Vector<T, Alloc> result(alloc_);
+        result.Reserve(Size());
+        ForEachReady([&result](T& item) {
+            result.EmplaceBack(std::move_if_noexcept(item));
+        });
+        Clear();
+        return result;
+    }
+
+    // Разрушает элементы и освобождает сегменты. Не потокобезопасен
+    void Clear() noexcept {
+        SlotAlloc slot_alloc(alloc_);
+        for (size_t segment = 0; segment < Layout::MAX_SEGMENTS; ++segment) {
+            Slot* slots = segments_[segment].exchange(nullptr, std::memory_order_acquire);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t segment_size = Layout::SegmentSize(segment);
+            for (size_t offset = 0; offset < segment_size; ++offset) {
+                if (slots[offset].ready.load(std::memory_order_relaxed)) {
+                    std::destroy_at(slots[offset].Get());
+                }
+            }
+            std::destroy_n(slots, segment_size);
+            SlotAllocTraits::deallocate(slot_alloc, slots, segment_size);
+        }
+        size_.store(0, std::memory_order_release);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    Slot& GetSlot(size_t index) const noexcept {
+        const size_t segment = Layout::SegmentOf(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots[index - Layout::SegmentStart(segment)];
+    }
+
+    template <typename Visitor>
+    void ForEachReady(Visitor visit) {
+        const size_t size = Size();
+        for (size_t segment = 0; segment < Layout::MAX_SEGMENTS && Layout::SegmentStart(segment) < size; ++segment) {
+            Slot* slots = segments_[segment].load(std::memory_order_acquire);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t count = std::min(Layout::SegmentSize(segment), size - Layout::SegmentStart(segment));
+            for (size_t offset = 0; offset < count; ++offset) {
+                if (slots[offset].ready.load(std::memory_order_acquire)) {
+                    visit(*slots[offset].Get());
+                }
+            }
+        }
+    }
+
+    Slot* GetOrAllocateSegment(size_t segment) {
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        SlotAlloc slot_alloc(alloc_);
+        const size_t segment_size = Layout::SegmentSize(segment);
+        Slot* new_slots = SlotAllocTraits::allocate(slot_alloc, segment_size);
+        std::uninitialized_default_construct_n(new_slots, segment_size);
+        if (segments_[segment].compare_exchange_strong(slots, new_slots, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return new_slots;
+        }
+        // Сегмент уже опубликован другим потоком
+        std::destroy_n(new_slots, segment_size);
+        SlotAllocTraits::deallocate(slot_alloc, new_slots, segment_size);
+        return slots;
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    std::atomic<size_t> size_{0};
+    std::atomic<Slot*> segments_[Layout::MAX_SEGMENTS] = {};
+};
@@ -0,0 +1,328 @@
+#pragma once
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+// Vector с копированием при записи. Копии CowVector разделяют один неизменяемый буфер со счётчиком
+// ссылок, поэтому копирование стоит одного атомарного инкремента, а снимок для чтения (GetSnapshot)
+// можно брать на каждый запрос. Изменяющий метод сначала копирует буфер, если им владеет кто-то ещё,
+// и меняет уже собственную копию; остальные владельцы продолжают видеть прежние данные.
+// Разные объекты, разделяющие буфер, можно читать и изменять из разных потоков; один объект, как и Vector,
+// требует внешней синхронизации. Итераторы и ссылки, полученные до изменяющего вызова, продолжают указывать
+// на прежний буфер, если он разделялся, и становятся недействительными, если нет.
+// Неконстантный доступ к элементам (Mutable, operator[], At) делает буфер неразделяемым: запись через
+// выданную ссылку не должна попасть в копию, поэтому такой вектор копируется и отдаёт снимки глубоким копированием
+template <typename T, typename Alloc = std::allocator<T>>
+class CowVector {
+public:
+    using Storage = Vector<T, Alloc>;
+    using Snapshot = std::shared_ptr<const Storage>;
+    using value_type = T;
+    using const_iterator = const T*;
+
+    // Пустой вектор не выделяет памяти до первого изменения
+    CowVector() noexcept
+        : data_(EmptyStorage()) {
+    }
+
+    explicit CowVector(const Alloc& alloc) noexcept
+        : data_(EmptyStorage())
+        , alloc_(alloc) {
+    }
+
+    explicit CowVector(Storage values)
+        : alloc_(values.GetAllocator()) {
+        Reset(std::move(values));
+    }
+
+    explicit CowVector(size_t size, const Alloc& alloc = Alloc())
+        : CowVector(Storage(size, alloc)) {
+    }
+
+    CowVector(std::initializer_list<T> values, const Alloc& alloc = Alloc())
+        : CowVector(Storage(values.begin(), values.end(), alloc)) {
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    CowVector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : CowVector(Storage(first, last, alloc)) {
+    }
+
+    CowVector(const CowVector& other)
+        : data_(other.Share())
+        , alloc_(other.alloc_) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) {
+        if (this != &rhs) {
+            data_ = rhs.Share();
+            alloc_ = rhs.alloc_;
+            unshareable_ = false;
+        }
+        return *this;
+    }
+
+    // Перемещённый вектор становится пустым и сохраняет свой аллокатор
+    CowVector(CowVector&& other) noexcept
+        : data_(std::exchange(other.data_, EmptyStorage()))
+        , alloc_(other.alloc_)
+        , unshareable_(std::exchange(other.unshareable_, false)) {
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            data_ = std::exchange(rhs.data_, EmptyStorage());
+            alloc_ = rhs.alloc_;
+            unshareable_ = std::exchange(rhs.unshareable_, false);
+        }
+        return *this;
+    }
+
+    void Swap(CowVector& other) noexcept {
+        data_.swap(other.data_);
+        std::swap(alloc_, other.alloc_);
+        std::swap(unshareable_, other.unshareable_);
+    }
+
+    // Аллокатор буферов вектора; сохраняется и тогда, когда вектор пуст и не владеет буфером
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const_iterator begin() const noexcept {
+        return data_->begin();
+    }
+
+    const_iterator end() const noexcept {
+        return data_->end();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return data_->Size();
+    }
+
+    bool Empty() const noexcept {
+        return data_->Size() == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_->Capacity();
+    }
+
+    const T* Data() const noexcept {
+        return data_->Data();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return (*data_)[index];
+    }
+
+    const T& At(size_t index) const {
+        return data_->At(index);
+    }
+
+    // Неизменяемый снимок текущего содержимого; живёт независимо от последующих изменений вектора.
+    // Неразделяемый буфер при этом копируется
+    Snapshot GetSnapshot() const {
+        return Share();
+    }
+
+    // Буфер разделяется с другими копиями или снимками
+    bool IsShared() const noexcept {
+        return !IsUnique();
+    }
+
+    // Собственный буфер для пакетного изменения: копирует данные не более одного раза на серию вызовов
+    Storage& Mutable() {
+        return Leak();
+    }
+
+    // Неконстантный доступ копирует разделяемый буфер
+    T& operator[](size_t index) {
+        return Leak()[index];
+    }
+
+    T& At(size_t index) {
+        return Leak().At(index);
+    }
+
+    void Reserve(size_t capacity) {
+        Unshare(capacity > Size() ? capacity - Size() : 0).Reserve(capacity);
+    }
+
+    void Resize(size_t size) {
+        Unshare(size > Size() ? size - Size() : 0).Resize(size);
+    }
+
+    // Разделяемый буфер не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (IsUnique()) {
+            data_->Clear();
+        } else {
+            data_ = EmptyStorage();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Разделяемый буфер копируется с местом под новый элемент, и элемент создаётся в копии, пока вектор
+    // ещё владеет прежним буфером. Поэтому args могут ссылаться на элементы вектора, даже если другие
+    // владельцы отпустят буфер во время вызова
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (IsUnique()) {
+            return data_->EmplaceBack(std::forward<Args>(args)...);
+        }
+        Storage copy = CopyWithRoom(1);
+        copy.EmplaceBack(std::forward<Args>(args)...);
+        Reset(std::move(copy));
+        return (*data_)[Size() - 1];
+    }
+
+    // Как и в Vector, на пустом векторе ничего не делает
+    void PopBack() {
+        if (Empty()) {
+            return;
+        }
+        if (IsUnique()) {
+            data_->PopBack();
+        } else {
+            Storage copy(CopyAllocator());
+            copy.Append(begin(), end() - 1);
+            Reset(std::move(copy));
+        }
+    }
+
+    // Позиции задаются итераторами этого вектора; возвращается итератор в его собственном буфере.
+    // Как и в EmplaceBack, args читаются, пока вектор владеет прежним буфером
+    template <typename... Args>
+    const_iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = pos - begin();
+        if (IsUnique()) {
+            return data_->Emplace(data_->begin() + index, std::forward<Args>(args)...);
+        }
+        Storage copy = CopyWithRoom(1);
+        copy.Emplace(copy.begin() + index, std::forward<Args>(args)...);
+        Reset(std::move(copy));
+        return begin() + index;
+    }
+
+    const_iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    const_iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    const_iterator Erase(const_iterator first, const_iterator last) {
+        const size_t index = first - begin();
+        const size_t count = last - first;
+        if (IsUnique()) {
+            return data_->Erase(first, last);
+        }
+        // Разделяемый буфер не копируется целиком: в копию попадают только оставшиеся элементы
+        Storage copy(CopyAllocator());
+        copy.Reserve(Size() - count);
+        copy.Append(begin(), first);
+        copy.Append(last, end());
+        Reset(std::move(copy));
+        return begin() + index;
+    }
+
+    friend bool operator==(const CowVector& lhs, const CowVector& rhs) {
+        return lhs.data_ == rhs.data_ || *lhs.data_ == *rhs.data_;
+    }
+
+    friend bool operator!=(const CowVector& lhs, const CowVector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    // Общий пустой буфер без владельца (use_count() == 0), поэтому первое изменение создаёт собственный.
+    // Его аллокатор не используется: новые буферы выделяются аллокатором alloc_
+    static std::shared_ptr<Storage> EmptyStorage() noexcept {
+        static Storage empty;
+        return std::shared_ptr<Storage>(std::shared_ptr<Storage>(), &empty);
+    }
+
+    // Единственный владелец буфера. Барьер упорядочивает последующую запись после чтений, которые
+    // другие владельцы выполнили до освобождения своих ссылок
+    bool IsUnique() const noexcept {
+        if (data_.use_count() != 1) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    // Делает буфер собственным, копируя разделяемый с запасом extra элементов под предстоящее изменение.
+    // Прежний буфер отпускается до возврата, поэтому изменение не должно читать его элементы
+    Storage& Unshare(size_t extra) {
+        if (!IsUnique()) {
+            Reset(CopyWithRoom(extra));
+        }
+        return *data_;
+    }
+
+    // Копия содержимого с запасом extra элементов
+    Storage CopyWithRoom(size_t extra) const {
+        Storage copy(CopyAllocator());
+        copy.Reserve(Size() + extra);
+        copy.Append(begin(), end());
+        return copy;
+    }
+
+    // Аллокатор копии буфера, как при копировании Vector
+    Alloc CopyAllocator() const {
+        return std::allocator_traits<Alloc>::select_on_container_copy_construction(alloc_);
+    }
+
+    // Собственный буфер, на элементы которого выдаются изменяемые ссылки. Такой буфер больше не разделяется
+    Storage& Leak() {
+        Storage& storage = Unshare(0);
+        unshareable_ = true;
+        return storage;
+    }
+
+    // Буфер для копии или снимка: разделяемый буфер отдаётся как есть, неразделяемый копируется
+    std::shared_ptr<Storage> Share() const {
+        if (!unshareable_) {
+            return data_;
+        }
+        Storage copy = CopyWithRoom(0);
+        return std::allocate_shared<Storage>(copy.GetAllocator(), std::move(copy));
+    }
+
+    // Новый буфер ещё никому не выдавал ссылок на элементы
+    void Reset(Storage&& values) {
+        data_ = std::allocate_shared<Storage>(values.GetAllocator(), std::move(values));
+        unshareable_ = false;
+    }
+
+    std::shared_ptr<Storage> data_;
+    [[no_unique_address]] Alloc alloc_;
+    // Через Mutable, operator[] или At выданы изменяемые ссылки в собственный буфер
+    bool unshareable_ = false;
+};
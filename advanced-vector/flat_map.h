@@ -0,0 +1,89 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "flat_set.h"
+#include "vector.h"
+
+// Упорядоченный словарь с уникальными ключами: пары std::pair<Key, T> хранятся в непрерывном Vector,
+// отсортированными по ключу. Поиск и стоимость операций те же, что у FlatSet. Значения можно изменять
+// через итераторы и ссылки, ключи — нельзя: это нарушит порядок элементов
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<Key, T>>>
+class FlatMap : public detail::FlatTree<std::pair<Key, T>, Key, detail::SelectFirst, Compare, Alloc> {
+    using Base = detail::FlatTree<std::pair<Key, T>, Key, detail::SelectFirst, Compare, Alloc>;
+
+public:
+    using mapped_type = T;
+    using iterator = std::pair<Key, T>*;
+    using const_iterator = typename Base::const_iterator;
+
+    using Base::Base;
+    using Base::begin;
+    using Base::end;
+    using Base::Find;
+
+    iterator begin() noexcept {
+        return this->data_.begin();
+    }
+
+    iterator end() noexcept {
+        return this->data_.end();
+    }
+
+    iterator Find(const Key& key) {
+        return this->data_.begin() + this->FindIndex(key);
+    }
+
+    T& At(const Key& key) {
+        return this->data_[CheckedIndex(key)].second;
+    }
+
+    const T& At(const Key& key) const {
+        return this->data_[CheckedIndex(key)].second;
+    }
+
+    // Значение по ключу; отсутствующий ключ вставляется со значением по умолчанию
+    T& operator[](const Key& key) {
+        return TryEmplace(key).first->second;
+    }
+
+    T& operator[](Key&& key) {
+        return TryEmplace(std::move(key)).first->second;
+    }
+
+    // Если ключа нет, создаёт пару из key и args прямо на её месте в векторе; иначе args не используются
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplace(K&& key, Args&&... args) {
+        const size_t index = this->LowerBoundIndex(key);
+        if (index != this->data_.Size() && !this->comp_(key, this->data_[index].first)) {
+            return {this->data_.begin() + index, false};
+        }
+        iterator pos = this->data_.Emplace(this->data_.begin() + index, std::piecewise_construct,
+                                           std::forward_as_tuple(std::forward<K>(key)),
+                                           std::forward_as_tuple(std::forward<Args>(args)...));
+        return {pos, true};
+    }
+
+    // Вставляет пару или присваивает значение уже существующему ключу
+    template <typename K, typename M>
+    std::pair<iterator, bool> InsertOrAssign(K&& key, M&& value) {
+        auto [pos, inserted] = TryEmplace(std::forward<K>(key), std::forward<M>(value));
+        if (!inserted) {
+            pos->second = std::forward<M>(value);
+        }
+        return {pos, inserted};
+    }
+
+private:
+    size_t CheckedIndex(const Key& key) const {
+        const size_t index = this->FindIndex(key);
+        if (index == this->data_.Size()) {
+            throw std::out_of_range("FlatMap key is not found");
+        }
+        return index;
+    }
+};
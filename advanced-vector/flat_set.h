@@ -0,0 +1,415 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+namespace detail {
+
+// Первый элемент отсортированного массива [first, first + n), для которого less(element, key) ложно.
+// Шаг поиска выбирает половину условной пересылкой вместо перехода, поэтому число итераций равно
+// ceil(log2(n)) для любого key и цикл не страдает от ошибок предсказания ветвлений.
+// Обе возможные следующие середины запрашиваются заранее, что скрывает задержку памяти на больших массивах
+template <typename T, typename Key, typename Less>
+const T* BranchlessLowerBound(const T* first, size_t n, const Key& key, Less less) {
+    if (n == 0) {
+        return first;
+    }
+    while (n > 1) {
+        const size_t half = n / 2;
+#if defined(__GNUC__)
+        __builtin_prefetch(first + half / 2);
+        __builtin_prefetch(first + half + half / 2);
+#endif
+        first = less(first[half], key) ? first + half : first;
+        n -= half;
+    }
+    return first + less(*first, key);
+}
+
+struct Identity {
+    template <typename T>
+    const T& operator()(const T& value) const noexcept {
+        return value;
+    }
+};
+
+struct SelectFirst {
+    template <typename Pair>
+    const typename Pair::first_type& operator()(const Pair& value) const noexcept {
+        return value.first;
+    }
+};
+
+}  // namespace detail
+
+// Неизменяемый снимок отсортированного набора в порядке Эйтцингера (обход полного двоичного дерева
+// в ширину): узел k (с единицы) имеет потомков 2k и 2k + 1. Верхние уровни дерева, через которые проходит
+// каждый поиск, лежат в нескольких строках кэша, а узлы нескольких следующих уровней запрашиваются
+// заранее, поэтому поиск на миллионах ключей заметно быстрее двоичного поиска в отсортированном массиве.
+// Порядок итерации снимка не совпадает с порядком ключей; снимок предназначен только для поиска
+template <typename Value, typename Key, typename KeyOf, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Value>>
+class EytzingerSnapshot {
+public:
+    using key_type = Key;
+    using value_type = Value;
+
+    EytzingerSnapshot() = default;
+
+    // Строит снимок из отсортированного по Compare массива без повторяющихся ключей
+    EytzingerSnapshot(const Value* sorted, size_t size, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+        : comp_(comp)
+        , data_(alloc) {
+        Vector<size_t> order(size, for_overwrite);
+        FillOrder(order, 0, 1);
+        data_.Reserve(size);
+        for (size_t node = 0; node < size; ++node) {
+            data_.EmplaceBack(sorted[order[node]]);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return data_.Size() == 0;
+    }
+
+    // Элемент с наименьшим ключом не меньше key или nullptr, если такого нет
+    const Value* LowerBound(const Key& key) const {
+        const Value* nodes = data_.begin();
+        const size_t size = data_.Size();
+        size_t k = 1;
+        while (k <= size) {
+#if defined(__GNUC__)
+            // Потомки узла k на log2(NODES_PER_LINE) уровней ниже занимают NODES_PER_LINE соседних ячеек
+            if (k * NODES_PER_LINE <= size) {
+                __builtin_prefetch(nodes + k * NODES_PER_LINE - 1);
+            }
+#endif
+            k = 2 * k + static_cast<size_t>(comp_(KeyOf()(nodes[k - 1]), key));
+        }
+        // Подъём по дереву до последнего узла, где поиск свернул влево: сбрасываются младшие единицы и ещё один бит
+        k >>= CountTrailingOnes(k) + 1;
+        return k == 0 ? nullptr : nodes + (k - 1);
+    }
+
+    const Value* Find(const Key& key) const {
+        const Value* candidate = LowerBound(key);
+        return candidate != nullptr && !comp_(key, KeyOf()(*candidate)) ? candidate : nullptr;
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != nullptr;
+    }
+
+private:
+    static constexpr size_t NODES_PER_LINE = sizeof(Value) >= 64 ? 1 : 64 / sizeof(Value);
+
+    static size_t CountTrailingOnes(size_t value) noexcept {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(~static_cast<unsigned long long>(value)));
+#else
+        size_t result = 0;
+        for (; value & 1; value >>= 1) {
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    // Записывает в order[k - 1] номер в отсортированном массиве элемента, попадающего в узел k поддерева
+    // с корнем k, обходя поддерево в симметричном порядке; next — номер очередного элемента
+    size_t FillOrder(Vector<size_t>& order, size_t next, size_t k) const noexcept {
+        if (k <= order.Size()) {
+            next = FillOrder(order, next, 2 * k);
+            order[k - 1] = next++;
+            next = FillOrder(order, next, 2 * k + 1);
+        }
+        return next;
+    }
+
+    [[no_unique_address]] Compare comp_;
+    Vector<Value, Alloc> data_;
+};
+
+namespace detail {
+
+// Общая часть FlatSet и FlatMap: элементы хранятся в Vector, отсортированными по ключу KeyOf()(value)
+// без повторений. Поиск — двоичный без ветвлений, вставка и удаление сдвигают хвост вектора
+template <typename Value, typename Key, typename KeyOf, typename Compare, typename Alloc>
+class FlatTree {
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using const_iterator = const Value*;
+    using Snapshot = EytzingerSnapshot<Value, Key, KeyOf, Compare, Alloc>;
+
+    FlatTree() = default;
+
+    explicit FlatTree(const Compare& comp, const Alloc& alloc = Alloc())
+        : comp_(comp)
+        , data_(alloc) {
+    }
+
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    FlatTree(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+        : FlatTree(comp, alloc) {
+        InsertUnsorted(first, last);
+    }
+
+    FlatTree(std::initializer_list<Value> values, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+        : FlatTree(values.begin(), values.end(), comp, alloc) {
+    }
+
+    const_iterator begin() const noexcept {
+        return data_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return data_.end();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return data_.begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return data_.end();
+    }
+
+    size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return data_.Size() == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    void Reserve(size_t capacity) {
+        data_.Reserve(capacity);
+    }
+
+    void ShrinkToFit() {
+        data_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        data_.Clear();
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    key_compare KeyComp() const {
+        return comp_;
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return data_.begin() + LowerBoundIndex(key);
+    }
+
+    const_iterator UpperBound(const Key& key) const {
+        return data_.begin() + UpperBoundIndex(key);
+    }
+
+    const_iterator Find(const Key& key) const {
+        return data_.begin() + FindIndex(key);
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != data_.Size();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Вставляет value, если его ключа ещё нет. Элемент создаётся прямо на своём месте в векторе
+    std::pair<const_iterator, bool> Insert(const Value& value) {
+        return InsertUnique(value);
+    }
+
+    std::pair<const_iterator, bool> Insert(Value&& value) {
+        return InsertUnique(std::move(value));
+    }
+
+    // Ключ создаваемого элемента становится известен только после его создания,
+    // поэтому элемент собирается во временном объекте и перемещается на место
+    template <typename... Args>
+    std::pair<const_iterator, bool> Emplace(Args&&... args) {
+        return InsertUnique(Value(std::forward<Args>(args)...));
+    }
+
+    // Добавляет элементы диапазона одной пакетной вставкой в конец, сортирует добавленное и сливает его
+    // с прежним содержимым, удаляя повторения, за O(n + k log k) вместо O(n k) при поштучной вставке.
+    // Из элементов с равными ключами остаётся прежний или первый в диапазоне. Порядок слияния выбирается
+    // одними сравнениями, и только затем элементы переносятся в новый буфер, поэтому при исключении
+    // из сравнения, копирования или выделения памяти добавленный хвост удаляется и контейнер остаётся прежним
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void InsertUnsorted(InputIt first, InputIt last) {
+        const size_t old_size = data_.Size();
+        data_.Append(first, last);
+        auto value_less = [this](const Value& lhs, const Value& rhs) {
+            return comp_(KeyOf()(lhs), KeyOf()(rhs));
+        };
+        try {
+            std::stable_sort(data_.begin() + old_size, data_.end(), value_less);
+            Vector<Value, Alloc> merged = MergeUnique(old_size, value_less);
+            data_.Swap(merged);
+        } catch (...) {
+            data_.Erase(data_.begin() + old_size, data_.end());
+            throw;
+        }
+    }
+
+    template <typename Range>
+    void InsertUnsorted(const Range& range) {
+        using std::begin;
+        using std::end;
+        InsertUnsorted(begin(range), end(range));
+    }
+
+    // Удаляет элемент с ключом key и возвращает число удалённых элементов
+    size_t Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == data_.Size()) {
+            return 0;
+        }
+        data_.Erase(data_.begin() + index);
+        return 1;
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        return data_.Erase(pos);
+    }
+
+    const_iterator Erase(const_iterator first, const_iterator last) {
+        return data_.Erase(first, last);
+    }
+
+    // Копия элементов в порядке Эйтцингера для частого поиска в редко изменяемых данных
+    Snapshot MakeSnapshot() const {
+        return Snapshot(data_.begin(), data_.Size(), comp_, data_.GetAllocator());
+    }
+
+    // Отсортированный по ключу вектор элементов
+    const Vector<Value, Alloc>& Values() const noexcept {
+        return data_;
+    }
+
+    friend bool operator==(const FlatTree& lhs, const FlatTree& rhs) {
+        return lhs.data_ == rhs.data_;
+    }
+
+    friend bool operator!=(const FlatTree& lhs, const FlatTree& rhs) {
+        return !(lhs == rhs);
+    }
+
+protected:
+    size_t LowerBoundIndex(const Key& key) const {
+        auto value_less = [this](const Value& value, const Key& k) { return comp_(KeyOf()(value), k); };
+        return BranchlessLowerBound(data_.begin(), data_.Size(), key, value_less) - data_.begin();
+    }
+
+    size_t UpperBoundIndex(const Key& key) const {
+        auto value_less_equal = [this](const Value& value, const Key& k) { return !comp_(k, KeyOf()(value)); };
+        return BranchlessLowerBound(data_.begin(), data_.Size(), key, value_less_equal) - data_.begin();
+    }
+
+    // Номер элемента с ключом key или Size(), если его нет
+    size_t FindIndex(const Key& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return index != data_.Size() && !comp_(key, KeyOf()(data_[index])) ? index : data_.Size();
+    }
+
+    template <typename V>
+    std::pair<const_iterator, bool> InsertUnique(V&& value) {
+        const Key& key = KeyOf()(value);
+        const size_t index = LowerBoundIndex(key);
+        if (index != data_.Size() && !comp_(key, KeyOf()(data_[index]))) {
+            return {data_.begin() + index, false};
+        }
+        return {data_.Emplace(data_.begin() + index, std::forward<V>(value)), true};
+    }
+
+    // Источник очередного элемента при слиянии в InsertUnsorted
+    enum class MergeStep : unsigned char { OLD, ADDED, SKIP };
+
+    // Сливает уникальный отсортированный префикс [0, old_size) с отсортированным хвостом в новый буфер
+    // без повторений. Сначала сравнения выбирают шаги слияния, не изменяя data_; затем элементы
+    // перемещаются, если перемещение не выбрасывает исключений, иначе копируются, поэтому при любом
+    // исключении data_ не изменяется
+    template <typename Less>
+    Vector<Value, Alloc> MergeUnique(size_t old_size, Less value_less) {
+        const Value* old_it = std::as_const(data_).begin();
+        const Value* const old_end = old_it + old_size;
+        const Value* added_it = old_end;
+        const Value* last_kept = nullptr;
+        Vector<MergeStep> steps;
+        steps.Reserve(data_.Size());
+        size_t kept = 0;
+        while (old_it != old_end || added_it != data_.end()) {
+            // При равных ключах прежний элемент идёт первым, и равный ему добавленный пропускается
+            if (old_it != old_end && (added_it == data_.end() || !value_less(*added_it, *old_it))) {
+                steps.PushBack(MergeStep::OLD);
+                last_kept = old_it++;
+                ++kept;
+            } else if (last_kept == nullptr || value_less(*last_kept, *added_it)) {
+                steps.PushBack(MergeStep::ADDED);
+                last_kept = added_it++;
+                ++kept;
+            } else {
+                steps.PushBack(MergeStep::SKIP);
+                ++added_it;
+            }
+        }
+        Vector<Value, Alloc> merged(data_.GetAllocator());
+        merged.Reserve(kept);
+        Value* old_src = data_.begin();
+        Value* added_src = old_src + old_size;
+        for (MergeStep step : steps) {
+            if (step == MergeStep::OLD) {
+                merged.EmplaceBack(std::move_if_noexcept(*old_src++));
+            } else if (step == MergeStep::ADDED) {
+                merged.EmplaceBack(std::move_if_noexcept(*added_src++));
+            } else {
+                ++added_src;
+            }
+        }
+        return merged;
+    }
+
+    [[no_unique_address]] Compare comp_;
+    Vector<Value, Alloc> data_;
+};
+
+}  // namespace detail
+
+// Упорядоченное множество уникальных ключей в непрерывном Vector. В отличие от узловых деревьев
+// поиск проходит по плотному массиву и не промахивается мимо кэша на каждом узле; вставка и удаление
+// стоят O(n) из-за сдвига хвоста, поэтому множество рассчитано на преобладание поиска.
+// Итераторы и ссылки становятся недействительными после любой вставки или удаления
+template <typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
+class FlatSet : public detail::FlatTree<Key, Key, detail::Identity, Compare, Alloc> {
+    using Base = detail::FlatTree<Key, Key, detail::Identity, Compare, Alloc>;
+
+public:
+    using iterator = typename Base::const_iterator;
+    using Base::Base;
+};
@@ -1,8 +1,31 @@
 #include "vector.h"
+#include "allocators.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+#include "test_harness.h"
+#include "vector_algorithms.h"
+#include "vector_parallel.h"
 
+#if defined(__linux__)
+#include "mapped_vector.h"
+#include "vector_io.h"
+
+#include <fcntl.h>
+#endif
+#include "vector_stats.h"
+
+#include <atomic>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace {
 
@@ -98,8 +121,146 @@ struct Obj {
     static inline int num_destroyed = 0;
 };
 
+// Аллокатор с состоянием: id отличает "арены", а счётчики позволяют проверить,
+// что память освобождается тем же аллокатором, которым была выделена
+template <typename T, bool Propagate>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U, Propagate>;
+    };
+
+    explicit ArenaAllocator(int id = 0) noexcept
+        : id(id) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Propagate>& other) noexcept
+        : id(other.id) {
+    }
+
+    T* allocate(size_t n) {
+        ++num_allocations[id];
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        --num_allocations[id];
+        operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, Propagate>& other) const noexcept {
+        return id == other.id;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U, Propagate>& other) const noexcept {
+        return id != other.id;
+    }
+
+    int id;
+    static inline int num_allocations[4] = {};
+};
+
+// Тип с нетривиальными конструктором перемещения и деструктором, объявленный тривиально перемещаемым
+struct RelocatableObj {
+    explicit RelocatableObj(int id = 0)
+        : id(id) {
+    }
+    RelocatableObj(const RelocatableObj& other)
+        : id(other.id) {
+        ++num_copied;
+    }
+    RelocatableObj(RelocatableObj&& other) noexcept
+        : id(other.id) {
+        ++num_moved;
+    }
+    RelocatableObj& operator=(const RelocatableObj& other) = default;
+    RelocatableObj& operator=(RelocatableObj&& other) = default;
+    ~RelocatableObj() {
+        ++num_destroyed;
+    }
+
+    int id;
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+// Тип, считающий перемещающие конструирования и присваивания
+struct ShiftObj {
+    explicit ShiftObj(int id = 0) noexcept
+        : id(id) {
+    }
+    ShiftObj(ShiftObj&& other) noexcept
+        : id(other.id) {
+        ++num_move_constructed;
+    }
+    ShiftObj& operator=(ShiftObj&& other) noexcept {
+        id = other.id;
+        ++num_move_assigned;
+        return *this;
+    }
+
+    int id;
+    static inline int num_move_constructed = 0;
+    static inline int num_move_assigned = 0;
+};
+
+// Тип с потокобезопасными счётчиками для проверки многопоточных операций.
+// Перемещение не помечено noexcept, поэтому при переносе элементы копируются
+struct ParallelObj {
+    ParallelObj() {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ParallelObj(const ParallelObj& other)
+        : id(other.id) {
+        if (other.throw_on_copy) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ParallelObj(ParallelObj&& other)
+        : id(other.id) {
+        ++num_alive;
+    }
+    ParallelObj& operator=(const ParallelObj& other) = default;
+    ~ParallelObj() {
+        --num_alive;
+    }
+
+    int id = 1;
+    bool throw_on_copy = false;
+    static inline std::atomic<int> construction_throw_countdown = 0;
+    static inline std::atomic<int> num_alive = 0;
+};
+
+struct StatsTestTag {
+    static constexpr const char* NAME = "stats_test";
+};
+
+struct StatsThreadTag {
+    static constexpr const char* NAME = "stats_thread";
+};
+
+struct StatsInPlaceTag {
+    static constexpr const char* NAME = "stats_in_place";
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<RelocatableObj> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -380,6 +541,2035 @@ void Test5() {
     }
 }
 
+void Test6() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        using Alloc = ArenaAllocator<Obj, true>;
+        Obj::ResetCounters();
+        {
+            Vector<Obj, Alloc> v1(SIZE, Alloc(1));
+            Vector<Obj, Alloc> v2(SIZE / 2, Alloc(2));
+            v1[0].id = ID;
+            assert(Alloc::num_allocations[1] == 1);
+            assert(Alloc::num_allocations[2] == 1);
+
+            // Копирование с propagate_on_container_copy_assignment забирает аллокатор rhs
+            v2 = v1;
+            assert(v2.GetAllocator().id == 1);
+            assert(v2[0].id == ID);
+            assert(Alloc::num_allocations[1] == 2);
+            assert(Alloc::num_allocations[2] == 0);
+
+            // Перемещение забирает буфер вместе с аллокатором, старый буфер освобождается сразу
+            Vector<Obj, Alloc> v3(SIZE, Alloc(3));
+            v3 = std::move(v1);
+            assert(v3.GetAllocator().id == 1);
+            assert(v1.Size() == 0);
+            assert(Alloc::num_allocations[3] == 0);
+
+            Vector<Obj, Alloc> v4(1, Alloc(2));
+            v4.Swap(v3);
+            assert(v4.GetAllocator().id == 1);
+            assert(v3.GetAllocator().id == 2);
+            assert(v4[0].id == ID);
+
+            // CopyAssignNoRealloc тоже передаёт аллокатор: буфер чужого аллокатора не переиспользуется
+            Vector<Obj, Alloc> v5(SIZE * 2, Alloc(3));
+            v5.CopyAssignNoRealloc(v4);
+            assert(v5.GetAllocator().id == 1 && v5.Size() == SIZE && v5[0].id == ID);
+            assert(Alloc::num_allocations[3] == 0);
+        }
+        assert(Alloc::num_allocations[1] == 0);
+        assert(Alloc::num_allocations[2] == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        using Alloc = ArenaAllocator<Obj, false>;
+        Obj::ResetCounters();
+        {
+            Vector<Obj, Alloc> v1(SIZE, Alloc(1));
+            Vector<Obj, Alloc> v2(SIZE / 2, Alloc(2));
+            v1[0].id = ID;
+
+            // Без распространения аллокатор остаётся своим
+            v2 = v1;
+            assert(v2.GetAllocator().id == 2);
+            assert(v2[0].id == ID);
+
+            // Неравные аллокаторы: элементы перемещаются поштучно в память своего аллокатора
+            const int old_move_count = Obj::num_moved;
+            Vector<Obj, Alloc> v3(1, Alloc(3));
+            v3 = std::move(v1);
+            assert(v3.GetAllocator().id == 3);
+            assert(v3.Size() == SIZE);
+            assert(v3[0].id == ID);
+            assert(v1.Size() == 0);
+            assert(Obj::num_moved - old_move_count == static_cast<int>(SIZE));
+            assert(Alloc::num_allocations[3] == 1);
+        }
+        assert(Alloc::num_allocations[1] == 0);
+        assert(Alloc::num_allocations[2] == 0);
+        assert(Alloc::num_allocations[3] == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test7() {
+    const size_t SIZE = 100;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<std::unique_ptr<int>>);
+    static_assert(!IsTriviallyRelocatableV<Obj>);
+    {
+        Vector<RelocatableObj> v;
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE);
+        for (size_t i = SIZE / 2; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Emplace(v.begin() + SIZE / 2, -1);
+        v.Reserve(SIZE * 4);
+        // Рост буфера не вызывает ни конструкторов перемещения, ни деструкторов
+        assert(RelocatableObj::num_moved == 0);
+        assert(RelocatableObj::num_copied == 0);
+        assert(RelocatableObj::num_destroyed == 0);
+        assert(v.Size() == SIZE + 1);
+        assert(v[SIZE / 2].id == -1);
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            assert(v[i].id == static_cast<int>(i));
+            assert(v[SIZE - i].id == static_cast<int>(SIZE - i - 1));
+        }
+    }
+    assert(RelocatableObj::num_destroyed == static_cast<int>(SIZE + 1));
+    {
+        Vector<std::unique_ptr<int>> v;
+        v.EmplaceBack(std::make_unique<int>(1));
+        v.EmplaceBack(std::make_unique<int>(2));
+        v.Emplace(v.begin(), std::make_unique<int>(0));
+        assert(v.Size() == 3);
+        assert(*v[0] == 0 && *v[1] == 1 && *v[2] == 2);
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 100'500;
+    static_assert(HasReallocateV<MallocAllocator<int>>);
+    static_assert(!HasReallocateV<std::allocator<int>>);
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE);
+        v.Reserve(SIZE * 3);
+        assert(v.Capacity() == SIZE * 3);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+    }
+    {
+        Vector<std::unique_ptr<int>, MallocAllocator<std::unique_ptr<int>>> v;
+        v.EmplaceBack(std::make_unique<int>(42));
+        assert(v.Size() == v.Capacity());
+        // Ссылка на элемент остаётся действительной во время расширения буфера
+        v.EmplaceBack(std::move(v[0]));
+        assert(v[0] == nullptr);
+        assert(*v[1] == 42);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(1);
+        v[0] = 42;
+        v.PushBack(v[0]);
+        assert(v[1] == 42);
+    }
+}
+
+void Test9() {
+    {
+        Vector<int, std::allocator<int>, MinCapacityGrowth<16>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 16);
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 32);
+    }
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        v.PushBack(1);
+        v.PushBack(2);
+        assert(v.Capacity() == 2);
+        v.PushBack(3);
+        assert(v.Capacity() == 3);
+        v.PushBack(4);
+        assert(v.Capacity() == 4);
+        v.PushBack(5);
+        assert(v.Capacity() == 6);
+    }
+    {
+        Vector<int, std::allocator<int>, PageRoundedGrowth<>> v(1500);
+        v.PushBack(0);
+        assert(v.Capacity() == 3072);
+        Vector<int, std::allocator<int>, PageRoundedGrowth<>> small(10);
+        small.PushBack(0);
+        assert(small.Capacity() == 20);
+    }
+    {
+        // Resize использует ту же политику роста, что и EmplaceBack
+        const size_t SIZE = 100'000;
+        Vector<int> v;
+        int num_reallocations = 0;
+        for (size_t i = 1; i <= SIZE; ++i) {
+            const size_t old_capacity = v.Capacity();
+            v.Resize(v.Size() + 1);
+            num_reallocations += v.Capacity() != old_capacity;
+        }
+        assert(v.Size() == SIZE);
+        assert(num_reallocations <= 20);
+    }
+    {
+        // Ёмкость включает весь блок, который вернул аллокатор
+        Vector<char, MallocAllocator<char>> v(3);
+        assert(v.Capacity() >= 3);
+        v.Reserve(100);
+        assert(v.Capacity() >= 100);
+    }
+}
+
+void Test10() {
+    const int ID = 42;
+    using Alloc = ArenaAllocator<Obj, false>;
+    Obj::ResetCounters();
+    {
+        SmallVector<Obj, 4, Alloc> v(Alloc(1));
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Пока элементы помещаются во встроенный буфер, куча не используется
+        assert(v.IsInline());
+        assert(v.Capacity() == 4);
+        assert(Alloc::num_allocations[1] == 0);
+
+        v.Emplace(v.begin() + 1, ID);
+        assert(!v.IsInline());
+        assert(v.Size() == 5);
+        assert(Alloc::num_allocations[1] == 1);
+        assert(v[0].id == 0 && v[1].id == ID && v[2].id == 1 && v[4].id == 3);
+
+        v.Erase(v.begin() + 1);
+        assert(v.Size() == 4);
+        assert(v[1].id == 1);
+
+        // Перемещение вектора в куче забирает буфер без перемещения элементов
+        const int old_move_count = Obj::num_moved;
+        SmallVector<Obj, 4, Alloc> moved(std::move(v));
+        assert(Obj::num_moved == old_move_count);
+        assert(moved.Size() == 4 && v.Size() == 0);
+
+        SmallVector<Obj, 4, Alloc> inline_v(Alloc(1));
+        inline_v.EmplaceBack(ID);
+        SmallVector<Obj, 4, Alloc> moved_inline(std::move(inline_v));
+        assert(moved_inline.IsInline());
+        assert(moved_inline[0].id == ID);
+        assert(inline_v.Size() == 0);
+
+        // Обмен в куче и встроенного
+        moved.Swap(moved_inline);
+        assert(moved.Size() == 1 && moved[0].id == ID && moved.IsInline());
+        assert(moved_inline.Size() == 4 && moved_inline[3].id == 3 && !moved_inline.IsInline());
+
+        // Обмен двух встроенных векторов разного размера
+        SmallVector<Obj, 4, Alloc> a(Alloc(1));
+        a.EmplaceBack(1);
+        a.EmplaceBack(2);
+        a.EmplaceBack(3);
+        a.Swap(moved);
+        assert(a.Size() == 1 && a[0].id == ID);
+        assert(moved.Size() == 3 && moved[2].id == 3);
+
+        moved = moved_inline;
+        assert(moved.Size() == 4 && moved[3].id == 3);
+        moved_inline = std::move(a);
+        assert(moved_inline.Size() == 1 && moved_inline[0].id == ID);
+
+        moved.Resize(10);
+        assert(moved.Size() == 10 && moved[3].id == 3 && moved[9].id == 0);
+        moved.Resize(2);
+        assert(moved.Size() == 2);
+    }
+    assert(Alloc::num_allocations[1] == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Неравные аллокаторы без распространения: перемещение может выделить память, поэтому не noexcept
+        using Small = SmallVector<Obj, 2, Alloc>;
+        static_assert(!std::is_nothrow_move_assignable_v<Small>);
+        static_assert(std::is_nothrow_move_assignable_v<SmallVector<Obj, 2>>);
+        static_assert(std::is_nothrow_move_assignable_v<SmallVector<Obj, 2, ArenaAllocator<Obj, true>>>);
+    }
+    using PropagatingAlloc = ArenaAllocator<Obj, true>;
+    {
+        // С распространением аллокатор rhs забирается и при копировании, и при перемещении из встроенного буфера;
+        // прежний буфер в куче освобождается своим аллокатором
+        using Small = SmallVector<Obj, 2, PropagatingAlloc>;
+        Small heap_v(PropagatingAlloc(2));
+        for (int i = 0; i < 3; ++i) {
+            heap_v.EmplaceBack(i);
+        }
+        Small inline_v(PropagatingAlloc(3));
+        inline_v.EmplaceBack(ID);
+        Small target(PropagatingAlloc(1));
+        for (int i = 0; i < 5; ++i) {
+            target.EmplaceBack(i);
+        }
+        target = inline_v;
+        assert(target.GetAllocator().id == 3 && target.IsInline() && target.Size() == 1 && target[0].id == ID);
+        assert(PropagatingAlloc::num_allocations[1] == 0);
+        target = heap_v;
+        assert(target.GetAllocator().id == 2 && target.Size() == 3 && target[2].id == 2);
+        assert(PropagatingAlloc::num_allocations[2] == 2);
+        target = std::move(inline_v);
+        assert(target.GetAllocator().id == 3 && target.IsInline() && target.Size() == 1);
+        assert(PropagatingAlloc::num_allocations[2] == 1);
+    }
+    assert(PropagatingAlloc::num_allocations[1] == 0);
+    assert(PropagatingAlloc::num_allocations[2] == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, 1> v(1);
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+}
+
+void Test11() {
+    const int ID = 42;
+    {
+        const int values[] = {1, 2, 3, 4, 5};
+        Vector<int> v(std::begin(values), std::end(values));
+        assert(v.Size() == 5 && v.Capacity() == 5);
+        assert(v[0] == 1 && v[4] == 5);
+
+        // Вставка диапазона в середину с перевыделением памяти
+        v.Insert(v.begin() + 2, std::begin(values), std::end(values));
+        const int expected[] = {1, 2, 1, 2, 3, 4, 5, 3, 4, 5};
+        assert(v.Size() == 10);
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+
+        // Вставка без перевыделения и вставка элементов самого вектора
+        v.Reserve(100);
+        auto it = v.Insert(v.begin() + 1, 3, v[0]);
+        assert(it == v.begin() + 1);
+        assert(v.Size() == 13 && v[1] == 1 && v[3] == 1 && v[4] == 2);
+        v.Insert(v.begin(), v.begin() + 4, v.begin() + 6);
+        assert(v.Size() == 15 && v[0] == 2 && v[1] == 1 && v[2] == 1);
+
+        v.Append(std::begin(values), std::end(values));
+        assert(v.Size() == 20 && v[19] == 5);
+        v.Append(v.begin(), v.begin() + 2);
+        assert(v.Size() == 22 && v[20] == 2 && v[21] == 1);
+    }
+    {
+        // Однопроходный диапазон
+        std::istringstream input("1 2 3 4");
+        Vector<int> v(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+        assert(v.Size() == 4 && v[3] == 4);
+        std::istringstream more("7 8");
+        v.Insert(v.begin() + 1, std::istream_iterator<int>(more), std::istream_iterator<int>{});
+        const int expected[] = {1, 7, 8, 2, 3, 4};
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+    }
+    {
+        // Хвост не тривиально перемещаемых элементов переносится однократно, а новые значения
+        // присваиваются освободившимся элементам
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(20);
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Insert(v.begin() + 5, 4, Obj(ID));
+        assert(v.Size() == 14);
+        assert(v[4].id == 4 && v[5].id == ID && v[8].id == ID && v[9].id == 5 && v[13].id == 9);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 4);
+
+        // Исключение при копировании оставляет вектор неизменным
+        Vector<Obj> source(3);
+        source[1].throw_on_copy = true;
+        try {
+            v.Insert(v.end() - 1, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 14 && v[0].id == 0 && v[12].id == 8 && v[13].id == 9);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<std::string> v(2);
+        v.Insert(v.begin() + 1, 2, "x");
+        assert(v.Size() == 4 && v[1] == "x" && v[2] == "x" && v[3].empty());
+    }
+    {
+        // Диапазон из самого вектора через итераторы, не являющиеся указателями, без перевыделения
+        const std::string values[] = {"a", "b", "c", "d"};
+        Vector<std::string> v(std::begin(values), std::end(values));
+        v.Reserve(100);
+        v.Insert(v.begin() + 1, std::make_reverse_iterator(v.end()), std::make_reverse_iterator(v.begin() + 2));
+        const std::string expected[] = {"a", "d", "c", "b", "c", "d"};
+        assert(v.Size() == 6 && std::equal(v.begin(), v.end(), std::begin(expected)));
+        v.Insert(v.begin(), std::make_move_iterator(v.begin() + 1), std::make_move_iterator(v.begin() + 3));
+        assert(v.Size() == 8 && v[0] == "d" && v[1] == "c" && v[2] == "a" && v[7] == "d");
+    }
+}
+
+void Test12() {
+    {
+        Vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        auto it = v.Erase(v.begin() + 2, v.begin() + 5);
+        assert(it == v.begin() + 2);
+        const int expected[] = {0, 1, 5, 6, 7, 8, 9};
+        assert(v.Size() == 7 && v.Capacity() == 16);
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+        assert(v.Erase(v.begin(), v.begin()) == v.begin() && v.Size() == 7);
+
+        assert(erase_if(v, [](int x) { return x % 2 == 1; }) == 4);
+        assert(v.Size() == 3 && v[0] == 0 && v[1] == 6 && v[2] == 8);
+        assert(erase(v, 6) == 1);
+        assert(v.Size() == 2 && v[1] == 8);
+
+        it = v.EraseUnordered(v.begin());
+        assert(v.Size() == 1 && *it == 8);
+        it = v.EraseUnordered(v.begin());
+        assert(v.Size() == 0 && it == v.end());
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Удаление диапазона разрушает ровно столько элементов, сколько удалено
+        const int old_destroyed = Obj::num_destroyed;
+        v.Erase(v.begin() + 1, v.begin() + 4);
+        assert(Obj::num_destroyed - old_destroyed == 3);
+        assert(v.Size() == 7 && v[0].id == 0 && v[1].id == 4 && v[6].id == 9);
+
+        assert(erase_if(v, [](const Obj& obj) { return obj.id > 5; }) == 4);
+        assert(v.Size() == 3 && v[2].id == 5);
+
+        v.EraseUnordered(v.begin());
+        assert(v.Size() == 2 && v[0].id == 5 && v[1].id == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(std::make_unique<int>(i));
+        }
+        v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(v.Size() == 3 && *v[0] == 0 && *v[1] == 3 && *v[2] == 4);
+        v.EraseUnordered(v.begin());
+        assert(v.Size() == 2 && *v[0] == 4 && *v[1] == 3);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 1000;
+    {
+        Vector<int> v(SIZE, for_overwrite);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2 && v[SIZE - 1] == static_cast<int>(SIZE - 1));
+
+        // Буфер заполняется снаружи, итоговый размер задаёт операция
+        v.ResizeAndOverwrite(SIZE * 4, [&](int* data, size_t n) {
+            assert(n == SIZE * 4);
+            assert(data[SIZE - 1] == static_cast<int>(SIZE - 1));
+            for (size_t i = SIZE; i < SIZE * 3; ++i) {
+                data[i] = -1;
+            }
+            return SIZE * 3;
+        });
+        assert(v.Size() == SIZE * 3);
+        assert(v[0] == 0 && v[SIZE] == -1 && v[SIZE * 3 - 1] == -1);
+    }
+    {
+        // Для нетривиальных типов инициализация по умолчанию вызывает конструктор по умолчанию
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v(10, for_overwrite);
+            v.ResizeDefaultInit(20);
+            assert(Obj::num_default_constructed == 20);
+            v.ResizeAndOverwrite(30, [](Obj* data, size_t) {
+                data[0].id = 42;
+                return 5;
+            });
+            assert(v.Size() == 5 && v[0].id == 42);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v[SIZE / 2].id = 42;
+        v.Reserve(SIZE * 4);
+        // Ёмкость превышает размер в 4 раза: при допустимых 8 память не освобождается
+        assert(!v.ShrinkIfWasted(8.0));
+        assert(v.Capacity() == SIZE * 4);
+        assert(v.ShrinkIfWasted(2.0));
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+        assert(v[SIZE / 2].id == 42);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Строгая гарантия: при исключении во время копирования вектор не меняется
+        struct ThrowingMove {
+            ThrowingMove() = default;
+            ThrowingMove(const ThrowingMove& other)
+                : obj(other.obj) {
+            }
+            ThrowingMove(ThrowingMove&& other) noexcept(false)
+                : obj(std::move(other.obj)) {
+            }
+            Obj obj;
+        };
+        Obj::ResetCounters();
+        Vector<ThrowingMove> v(SIZE);
+        v.Reserve(SIZE * 2);
+        v[SIZE - 1].obj.throw_on_copy = true;
+        try {
+            v.ShrinkToFit();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE * 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE * 10);
+        v.Resize(SIZE);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+    }
+}
+
+void Test15() {
+    using StatsVector = Vector<int, std::allocator<int>, DoublingGrowth, CountingStats<StatsTestTag>>;
+    const VectorStats& stats = CountingStats<StatsTestTag>::Get();
+    {
+        StatsVector v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        // Буферы ёмкостью 1, 2, 4 и 8; при трёх заменах перенесено 1 + 2 + 4 элемента
+        assert(stats.allocations == 4);
+        assert(stats.bytes_allocated == (1 + 2 + 4 + 8) * sizeof(int));
+        assert(stats.reallocations == 3);
+        assert(stats.elements_relocated == 7);
+        assert(stats.peak_capacity == 8);
+
+        StatsVector copy(v);
+        copy.Reserve(100);
+        assert(stats.allocations == 6);
+        assert(stats.reallocations == 4);
+        assert(stats.peak_capacity == 100);
+    }
+    bool found = false;
+    for (const VectorStatsSnapshot& snapshot : VectorStatsRegistry::Instance().Collect()) {
+        if (std::string(snapshot.name) == StatsTestTag::NAME) {
+            found = true;
+            assert(snapshot.allocations == 6);
+            assert(snapshot.elements_relocated == 15);
+        }
+    }
+    assert(found);
+
+    // Группы регистрируются без выделения памяти, в том числе параллельно с Collect
+    static_assert(noexcept(CountingStats<StatsThreadTag>::OnAllocate(1, 1)));
+    std::thread registering([] {
+        Vector<int, std::allocator<int>, DoublingGrowth, CountingStats<StatsThreadTag>> v(3);
+    });
+    const size_t groups_before = VectorStatsRegistry::Instance().Collect().Size();
+    registering.join();
+    size_t thread_groups = 0;
+    for (const VectorStatsSnapshot& snapshot : VectorStatsRegistry::Instance().Collect()) {
+        if (std::string(snapshot.name) == StatsThreadTag::NAME) {
+            ++thread_groups;
+            assert(snapshot.allocations == 1 && snapshot.peak_capacity == 3);
+        }
+    }
+    assert(thread_groups == 1 && groups_before >= 1);
+
+    // Расширение через realloc считается заменой буфера, но не поэлементным переносом
+    {
+        const VectorStats& in_place = CountingStats<StatsInPlaceTag>::Get();
+        Vector<int, MallocAllocator<int>, DoublingGrowth, CountingStats<StatsInPlaceTag>> v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        v.Reserve(100);
+        v.ShrinkToFit();
+        assert(in_place.reallocations == 5 && in_place.elements_relocated == 0);
+    }
+    // Вектор без статистики не больше обычного
+    static_assert(sizeof(Vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+}
+
+void Test16() {
+    const size_t SIZE = 1000;
+    {
+        Vector<float, AlignedAllocator<float>> v(SIZE);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 64 == 0);
+        // Ёмкость кратна 16 float (512 бит), хвост обрабатывается полным регистром
+        assert(v.Capacity() % 16 == 0 && v.Capacity() >= SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(1.0f);
+        }
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 64 == 0);
+        assert(v.Capacity() % 16 == 0);
+        assert(v[SIZE * 2 - 1] == 1.0f);
+    }
+    {
+        Vector<double, AlignedAllocator<double, 32>> v;
+        v.PushBack(1.0);
+        assert(v.Capacity() == 4);
+        v.Reserve(5);
+        assert(v.Capacity() == 8);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 32 == 0);
+    }
+}
+
+template <typename T>
+void TestBulkAlgorithms() {
+    // Размеры вокруг границ регистров всех ширин
+    for (size_t size : {1, 7, 16, 33, 64, 127, 1000, 40'000}) {
+        Vector<T> v(size);
+        Fill(v, T(3));
+        assert(Count(v, T(3)) == size);
+        assert(Find(v, T(5)) == v.end());
+        v[size / 2] = T(5);
+        v[size - 1] = T(1);
+        v[0] = T(7);
+        assert(Find(v, T(5)) == v.begin() + size / 2 || size < 3);
+        assert(Find(v, T(7)) == v.begin());
+        assert(Count(v, T(3)) == (size < 3 ? 0 : size - 3 + (size / 2 == size - 1 || size / 2 == 0 ? 1 : 0)));
+
+        T expected_sum{};
+        for (const T& x : v) {
+            expected_sum += x;
+        }
+        assert(Sum(v) == expected_sum);
+
+        auto [min, max] = MinMax(v);
+        assert(min == *std::min_element(v.begin(), v.end()));
+        assert(max == *std::max_element(v.begin(), v.end()));
+
+        Vector<T> copy(v);
+        assert(Equal(v, copy) && v == copy);
+        copy[size - 1] = T(v[size - 1] + 1);
+        assert(!Equal(v, copy) && v != copy);
+        assert(v < copy && copy > v && v <= copy && copy >= v);
+    }
+    // Значение приводится к типу элементов, а не выводит T вместе с вектором
+    Vector<T> v(10);
+    Fill(v, 3);
+    assert(Count(v, 3) == 10 && Find(v, 3) == v.begin() && Find(v, 4) == v.end());
+}
+
+void Test17() {
+    TestBulkAlgorithms<int>();
+    TestBulkAlgorithms<unsigned char>();
+    TestBulkAlgorithms<int64_t>();
+    TestBulkAlgorithms<float>();
+    TestBulkAlgorithms<double>();
+    {
+        // Нечисловые типы обрабатываются скалярными алгоритмами
+        using namespace std::literals;
+        Vector<std::string> a(3);
+        Fill(a, "x"s);
+        assert(Count(a, "x"s) == 3 && Find(a, "y"s) == a.end());
+        assert(Sum(a) == "xxx"s);
+        Vector<std::string> b(a);
+        b[1] = "a"s;
+        assert(Equal(a, a) && a != b && b < a);
+        assert(MinMax(b) == std::make_pair("a"s, "x"s));
+    }
+    {
+        Vector<int> empty;
+        assert(Sum(empty) == 0 && Find(empty, 1) == empty.end() && empty == Vector<int>{});
+    }
+#if defined(ADVANCED_VECTOR_SIMD)
+    {
+        // Базовые ядра проверяются напрямую, даже если процессор поддерживает более широкие регистры
+        const auto& kernels = detail::simd::BaselineKernels<float>::Table();
+        Vector<float> v(100);
+        kernels.fill(v.begin(), v.Size(), 0.5f);
+        v[77] = -1.0f;
+        assert(kernels.find(v.begin(), v.Size(), -1.0f) == 77);
+        assert(kernels.count(v.begin(), v.Size(), 0.5f) == 99);
+        assert(kernels.sum(v.begin(), v.Size()) == 48.5f);
+        float min = 0;
+        float max = 0;
+        kernels.min_max(v.begin(), v.Size(), min, max);
+        assert(min == -1.0f && max == 0.5f);
+        assert(kernels.equal(v.begin(), v.begin(), v.Size()));
+    }
+#endif
+}
+
+void Test18() {
+    const size_t SIZE = 1000;
+    const ParallelPolicy policy{4, 16};
+    assert(policy.ChunkCount(SIZE) == 4 && policy.ChunkCount(40) == 2 && policy.ChunkCount(10) == 1);
+    {
+        Vector<ParallelObj> v(SIZE, policy);
+        assert(v.Size() == SIZE && ParallelObj::num_alive == static_cast<int>(SIZE));
+        assert(std::all_of(v.begin(), v.end(), [](const ParallelObj& obj) { return obj.id == 1; }));
+
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        Vector<ParallelObj> copy(v, policy);
+        assert(copy.Size() == SIZE && ParallelObj::num_alive == static_cast<int>(2 * SIZE));
+        copy.Reserve(SIZE * 2, policy);
+        assert(copy.Capacity() == SIZE * 2 && ParallelObj::num_alive == static_cast<int>(2 * SIZE));
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(copy[i].id == static_cast<int>(i));
+        }
+        copy.Clear(policy);
+        assert(copy.Size() == 0 && ParallelObj::num_alive == static_cast<int>(SIZE));
+    }
+    assert(ParallelObj::num_alive == 0);
+    {
+        // Исключение в одной из частей: созданные элементы остальных частей разрушаются
+        ParallelObj::construction_throw_countdown = SIZE * 3 / 4;
+        try {
+            Vector<ParallelObj> v(SIZE, policy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        ParallelObj::construction_throw_countdown = 0;
+        assert(ParallelObj::num_alive == 0);
+    }
+    {
+        Vector<ParallelObj> v(SIZE, policy);
+        v[SIZE / 3].throw_on_copy = true;
+        try {
+            Vector<ParallelObj> copy(v, policy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(ParallelObj::num_alive == static_cast<int>(SIZE));
+        // Перенос в Reserve обеспечивает строгую гарантию: вектор остаётся неизменным
+        try {
+            v.Reserve(SIZE * 2, policy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == SIZE && v.Size() == SIZE && ParallelObj::num_alive == static_cast<int>(SIZE));
+    }
+    assert(ParallelObj::num_alive == 0);
+    {
+        Vector<int> v(SIZE, policy);
+        assert(std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        v.Reserve(SIZE * 3, policy);
+        Vector<int> copy(v, policy);
+        assert(copy == v && v.Capacity() == SIZE * 3 && v[SIZE - 1] == static_cast<int>(SIZE - 1));
+    }
+    {
+        // Политика по умолчанию обрабатывает маленькие векторы в вызывающем потоке
+        Vector<std::string> v(10, parallel);
+        v[5] = "five";
+        Vector<std::string> copy(v, parallel);
+        assert(copy == v);
+    }
+}
+
+#if defined(__linux__)
+// Политика размещения NUMA, действующая для страницы по адресу p
+int GetMemoryPolicy(const void* p) {
+    int mode = -1;
+    if (syscall(SYS_get_mempolicy, &mode, nullptr, 0, p, MPOL_F_ADDR) != 0) {
+        return -1;  // ядро без поддержки NUMA
+    }
+    return mode;
+}
+
+void Test19() {
+    const size_t SIZE = 100'000;
+    {
+        using Alloc = NumaAllocator<double>;
+        Vector<double, Alloc> v(SIZE, Alloc(NumaPlacement::INTERLEAVE));
+        assert(v.Capacity() * sizeof(double) % detail::PageSize() == 0);
+        assert(std::all_of(v.begin(), v.end(), [](double x) { return x == 0.0; }));
+        const int mode = GetMemoryPolicy(v.begin());
+        assert(mode == -1 || mode == MPOL_INTERLEAVE);
+
+        v[SIZE - 1] = 42.0;
+        v.Reserve(SIZE * 4);  // mremap переносит страницы вместе с политикой отображения
+        assert(v[SIZE - 1] == 42.0 && v.Capacity() >= SIZE * 4);
+        assert(GetMemoryPolicy(v.begin() + SIZE * 3) == mode);
+
+        // Копирующее присваивание передаёт аллокатор и размещает буфер по его политике
+        Vector<double, Alloc> bound(10, Alloc(NumaPlacement::BIND, 1));
+        bound = v;
+        assert(bound.GetAllocator() == v.GetAllocator() && bound == v);
+        assert(GetMemoryPolicy(bound.begin()) == mode);
+    }
+    {
+        using Alloc = NumaAllocator<std::string>;
+        Vector<std::string, Alloc> v(SIZE, parallel);
+        assert(v.GetAllocator().GetPlacement() == NumaPlacement::FIRST_TOUCH);
+        v[SIZE / 2] = "middle";
+        v.Reserve(SIZE * 2, parallel);
+        assert(v[SIZE / 2] == "middle" && v.Size() == SIZE);
+        Vector<std::string, Alloc> copy(v, parallel);
+        assert(copy == v);
+        v.Clear(parallel);
+    }
+}
+
+struct Record {
+    uint64_t id;
+    double value;
+};
+
+void Test20() {
+    const std::string path = "/tmp/mapped_vector_test_" + std::to_string(getpid()) + ".bin";
+    const size_t SIZE = 10'000;
+    {
+        MappedVector<Record> records(path, MappedMode::CREATE);
+        assert(records.Size() == 0 && records.Capacity() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            records.PushBack({i, i * 0.5});
+        }
+        records.PushBack(records[0]);  // ссылка на элемент остаётся действительной при росте отображения
+        assert(records.Size() == SIZE + 1 && records[SIZE].id == 0);
+        records.PopBack();
+        records.Sync();
+        static_assert(!std::is_convertible_v<std::string, MappedVector<Record>>);
+    }
+    {
+        MappedVector<Record> records(path);
+        assert(records.Size() == SIZE && records.Capacity() >= SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(records[i].id == i && records[i].value == i * 0.5);
+        }
+        records.Resize(SIZE * 3);
+        assert(records[SIZE * 3 - 1].id == 0 && records[SIZE - 1].id == SIZE - 1);
+        records[SIZE * 2].id = 42;
+    }
+    {
+        MappedVector<Record> opened(path, MappedMode::READ_ONLY);
+        const MappedVector<Record> records(std::move(opened));
+        assert(records.IsReadOnly() && records.Size() == SIZE * 3);
+        // Перемещённый вектор пуст и доступен только для чтения
+        assert(opened.Size() == 0 && opened.Capacity() == 0 && opened.begin() == opened.end() && opened.IsReadOnly());
+        opened.Sync();
+        assert(records[SIZE * 2].id == 42);
+        size_t sum = 0;
+        for (const Record& record : records) {
+            sum += record.id;
+        }
+        assert(sum == SIZE * (SIZE - 1) / 2 + 42);
+    }
+    try {
+        // Размер элемента записан в заголовке и проверяется при открытии
+        MappedVector<uint32_t> wrong(path, MappedMode::READ_ONLY);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error& e) {
+        assert(std::string(e.what()).find("element size") != std::string::npos);
+    }
+    std::remove(path.c_str());
+    try {
+        MappedVector<Record> missing(path, MappedMode::READ_ONLY);
+        assert(false && "Exception is expected");
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+}
+
+void Test21() {
+    const std::string path = "/tmp/vector_io_test_" + std::to_string(getpid()) + ".bin";
+    const size_t SIZE = 10'000;
+    Vector<Record> records;
+    for (size_t i = 0; i < SIZE; ++i) {
+        records.PushBack({i, i * 0.25});
+    }
+    {
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        WriteVector(fd, records);
+        WriteVector(fd, Vector<Record>{});
+        WriteVector(fd, Vector<uint32_t>(3));
+        close(fd);
+    }
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        assert(fd >= 0);
+        const auto restored = ReadVector<Record>(fd);
+        assert(restored.Size() == SIZE && restored[SIZE - 1].id == SIZE - 1 && restored[SIZE - 1].value == (SIZE - 1) * 0.25);
+        assert(ReadVector<Record>(fd).Size() == 0);
+        try {
+            ReadVector<uint64_t>(fd);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error& e) {
+            assert(std::string(e.what()).find("element size") != std::string::npos);
+        }
+        close(fd);
+    }
+    std::remove(path.c_str());
+}
+
+// Проверяет, что адрес p выровнен по огромной странице
+bool IsHugePageAligned(const void* p) {
+    return reinterpret_cast<uintptr_t>(p) % HugePageAllocator<char>::HUGE_PAGE_SIZE == 0;
+}
+
+void Test23() {
+    const size_t HUGE_PAGE_ELEMENTS = HugePageAllocator<uint64_t>::HUGE_PAGE_SIZE / sizeof(uint64_t);
+    {
+        Vector<uint64_t, HugePageAllocator<uint64_t>> v;
+        v.Reserve(100);
+        assert(v.Capacity() == 100);  // буфер меньше порога выделяется обычным способом
+
+        for (uint64_t i = 0; i < HUGE_PAGE_ELEMENTS * 3; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() % HUGE_PAGE_ELEMENTS == 0 && IsHugePageAligned(v.begin()));
+        v.Reserve(v.Capacity() * 4);  // рост через mremap остаётся на выровненных огромных страницах
+        assert(IsHugePageAligned(v.begin()));
+        for (uint64_t i = 0; i < HUGE_PAGE_ELEMENTS * 3; ++i) {
+            assert(v[i] == i);
+        }
+        v.Resize(10);
+        v.ShrinkToFit();  // возврат с огромных страниц в обычный буфер
+        assert(v.Capacity() == 10 && v[9] == 9);
+    }
+    {
+        // Нетривиально перемещаемые элементы переносятся в новый буфер поэлементно
+        using Alloc = HugePageAllocator<std::string, 4096>;
+        Vector<std::string, Alloc> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(v.Capacity() % (Alloc::HUGE_PAGE_SIZE / sizeof(std::string)) == 0 && IsHugePageAligned(v.begin()));
+        assert(v[999] == "999" && v[0] == "0");
+    }
+}
+#endif
+
+void Test22() {
+    Obj::ResetCounters();
+    {
+        Vector<Obj> v;
+        v.Reserve(10);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        const auto buffer = v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.begin() == nullptr);
+        assert(buffer.size == 2 && buffer.capacity == 10 && buffer.ptr[1].id == 2);
+
+        Vector<Obj> adopted(3);
+        adopted.Adopt(buffer.ptr, buffer.size, buffer.capacity);
+        assert(adopted.Size() == 2 && adopted.Capacity() == 10 && adopted.begin() == buffer.ptr);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 0 && Obj::GetAliveObjectCount() == 2);
+        adopted.EmplaceBack(3);
+        assert(adopted[2].id == 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Буфер, заполненный вне вектора, например принятый из сети
+        std::allocator<int> alloc;
+        int* received = alloc.allocate(100);
+        std::fill_n(received, 100, 7);
+        Vector<int> v;
+        v.Adopt(received, 100, 100);
+        assert(v.Size() == 100 && Count(v, 7) == 100);
+    }
+}
+
+void Test24() {
+    const int THREADS = 8;
+    const int PER_THREAD = 20'000;
+    {
+        ConcurrentVector<std::pair<int, int>> log;
+        const auto& first = log.EmplaceBack(-1, -1);
+        std::atomic<bool> done = false;
+        std::thread reader([&] {
+            // Созданные элементы можно читать во время добавления
+            while (!done.load()) {
+                const size_t size = log.Size();
+                for (size_t i = 0; i < size; i += 997) {
+                    if (log.IsReady(i)) {
+                        const auto& record = log[i];
+                        assert(record.first == -1 || (record.second >= 0 && record.second < PER_THREAD));
+                    }
+                }
+            }
+        });
+        Vector<std::thread> writers;
+        for (int t = 0; t < THREADS; ++t) {
+            writers.EmplaceBack([&log, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    log.EmplaceBack(t, i);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        assert(log.Size() == THREADS * PER_THREAD + 1);
+        assert(&first == &log[0] && first.first == -1);  // элементы не перемещаются при росте
+
+        const auto compacted = log.Compact();
+        assert(log.Size() == 0 && compacted.Size() == THREADS * PER_THREAD + 1);
+        // Элементы каждого потока идут в порядке добавления
+        Vector<int> next(THREADS);
+        for (size_t i = 1; i < compacted.Size(); ++i) {
+            const auto [thread, value] = compacted[i];
+            assert(value == next[thread]);
+            ++next[thread];
+        }
+    }
+    Obj::ResetCounters();
+    {
+        ConcurrentVector<Obj, std::allocator<Obj>, 4> v;
+        v.EmplaceBack(1);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        v.EmplaceBack(3);
+        assert(v.Size() == 3 && v.IsReady(0) && !v.IsReady(1) && v.IsReady(2) && !v.IsReady(3));
+        const auto compacted = v.Compact();  // пустая ячейка пропускается
+        assert(compacted.Size() == 2 && compacted[1].id == 3);
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v[99].id == 99);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test25() {
+    const size_t SIZE = 10'000;
+    Obj::ResetCounters();
+    {
+        SegmentedVector<Obj> v;
+        const Obj& first = v.EmplaceBack(0);
+        for (size_t i = 1; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+            v.PushBack(v[0]);  // ссылка на элемент остаётся действительной при росте
+            v.PopBack();
+        }
+        assert(&first == &v[0] && v.Size() == SIZE && v.Capacity() >= SIZE);
+        assert(Obj::num_moved == 0);  // рост не перемещает элементы
+        size_t index = 0;
+        for (const Obj& obj : v) {
+            assert(obj.id == static_cast<int>(index));
+            ++index;
+        }
+        assert(index == SIZE && v.end() - v.begin() == static_cast<ptrdiff_t>(SIZE));
+        assert((v.begin() + 5000)->id == 5000 && v.begin()[17].id == 17 && (v.end() - 1)->id == SIZE - 1);
+
+        SegmentedVector<Obj> copy(v);
+        assert(copy.Size() == SIZE && copy[SIZE - 1].id == SIZE - 1);
+        SegmentedVector<Obj> moved(std::move(copy));
+        assert(copy.Size() == 0 && moved.Size() == SIZE && &moved[0] != &v[0]);
+        copy = moved;
+        moved = std::move(copy);
+        assert(moved.Size() == SIZE && Obj::GetAliveObjectCount() == static_cast<int>(2 * SIZE));
+
+        moved.Resize(10);
+        moved.ShrinkToFit();
+        assert(moved.Size() == 10 && moved.Capacity() == 16);
+        moved.Clear();
+        assert(moved.Size() == 0 && moved.Capacity() == 16);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Итераторы произвольного доступа подходят для алгоритмов стандартной библиотеки
+        SegmentedVector<int, std::allocator<int>, 4> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack((i * 7919) % 1000);
+        }
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && std::adjacent_find(v.begin(), v.end()) == v.end());
+        const SegmentedVector<int, std::allocator<int>, 4>& cv = v;
+        assert(*std::lower_bound(cv.begin(), cv.end(), 500) == 500);
+    }
+    {
+        // Вставка и удаление в середине сдвигают только хвост; элементы перед позицией не перемещаются
+        SegmentedVector<int, std::allocator<int>, 4> v;
+        for (int i = 0; i < 30; ++i) {
+            v.PushBack(i);
+        }
+        const int* head = &v[2];
+        auto it = v.Insert(v.begin() + 3, 100);
+        assert(*it == 100 && v.Size() == 31 && v[2] == 2 && v[4] == 3 && v[30] == 29 && head == &v[2]);
+        it = v.Emplace(v.cbegin() + 5, v[30]);  // аргумент — элемент самого вектора
+        assert(*it == 29 && v.Size() == 32 && v[6] == 4 && v[31] == 29);
+        v.Insert(v.end(), -1);
+        assert(v.Size() == 33 && v[32] == -1);
+        it = v.Erase(v.begin() + 3);
+        assert(*it == 3 && v.Size() == 32 && head == &v[2]);
+        it = v.Erase(v.begin() + 4, v.begin() + 20);
+        assert(v.Size() == 16 && v[3] == 3 && *it == 19 && v[15] == -1);
+        it = v.Erase(v.begin() + 10, v.end());
+        assert(it == v.end() && v.Size() == 10);
+        for (int i = 0; i < 4; ++i) {
+            assert(v[i] == i);
+        }
+        // Как и у Vector, PopBack пустого вектора ничего не делает
+        v.Clear();
+        v.PopBack();
+        assert(v.Size() == 0);
+    }
+    Obj::ResetCounters();
+    {
+        SegmentedVector<Obj> v(20);
+        v[10].throw_on_copy = true;
+        try {
+            SegmentedVector<Obj> copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 20);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test26() {
+    {
+        SoaVector<float, float, int> particles;
+        for (int i = 0; i < 1000; ++i) {
+            particles.EmplaceBack(i * 1.0f, i * 2.0f, i);
+        }
+        assert(particles.Size() == 1000 && particles.Capacity() >= 1000);
+        float sum = 0;
+        for (float x : particles.Column<0>()) {
+            sum += x;
+        }
+        assert(sum == 999 * 1000 / 2);
+        assert(particles.Column<2>().Size() == 1000 && particles.Column<2>()[999] == 999);
+
+        particles.Emplace(1, -1.0f, -2.0f, -1);
+        assert(particles.Get<0>(1) == -1.0f && particles.Get<2>(1) == -1 && particles.Get<2>(2) == 1);
+        particles.Erase(0);
+        assert(particles.Size() == 1000 && particles.Get<2>(0) == -1 && particles.Get<1>(999) == 1998.0f);
+
+        const SoaVector<float, float, int> copy(particles);
+        assert(copy.Size() == 1000 && copy.Column<1>()[500] == particles.Get<1>(500));
+        particles.Resize(10);
+        particles.PopBack();
+        assert(particles.Size() == 9 && particles.Get<2>(8) == 8);
+        particles.Clear();
+        particles.PopBack();
+        assert(particles.Size() == 0);
+    }
+    {
+        // Аргументы могут ссылаться на элементы вектора, даже если вставка требует перевыделения
+        SoaVector<std::string, int> v;
+        v.EmplaceBack("first string that does not fit into SSO", 1);
+        v.Reserve(1);
+        assert(v.Capacity() == 1);
+        v.EmplaceBack(v.Get<0>(0), v.Get<1>(0));
+        v.Emplace(0, v.Get<0>(1), 0);
+        assert(v.Size() == 3 && v.Get<0>(0) == v.Get<0>(2) && v.Get<1>(0) == 0 && v.Get<1>(2) == 1);
+    }
+    {
+        // Столбец с бросающим перемещением: вставка и удаление в середине перестраивают столбцы с копированием
+        SoaVector<ParallelObj, int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(ParallelObj(), i);
+        }
+        v.Get<0>(5).throw_on_copy = true;
+        const size_t capacity = v.Capacity();
+        try {
+            v.Emplace(2, ParallelObj(), 100);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 10 && v.Capacity() == capacity && v.Get<1>(2) == 2 && v.Get<0>(5).throw_on_copy);
+        try {
+            v.Reserve(capacity * 2);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == capacity && ParallelObj::num_alive == 10);
+        v.Get<0>(5).throw_on_copy = false;
+        v.Erase(3);
+        assert(v.Size() == 9 && v.Get<1>(3) == 4 && ParallelObj::num_alive == 9);
+    }
+    assert(ParallelObj::num_alive == 0);
+    {
+        // Erase сдвигает столбцы с бросающим перемещением на месте: отказать может только присваивание,
+        // после отказа все записи остаются действительными
+        using Soa = SoaVector<ThrowingMoveTrackedObj, int>;
+        auto make = [] {
+            Soa v;
+            for (int i = 0; i < 8; ++i) {
+                v.EmplaceBack(ThrowingMoveTrackedObj(i), i);
+            }
+            return v;
+        };
+        const size_t points = InjectFailures(make, [](Soa& v) { v.Erase(2); }, [](const Soa& v, bool failed) {
+            if (failed) {
+                assert(v.Size() == 8 && v.Get<1>(2) == 2 && v.Get<1>(7) == 7);
+            } else {
+                assert(v.Size() == 7 && v.Get<0>(2).value == 3 && v.Get<1>(2) == 3 && v.Get<0>(6).value == 7);
+            }
+        });
+        assert(points == 5);
+    }
+}
+
+void Test27() {
+    Vector<int> v(3);
+    v[1] = 5;
+    assert(v.At(1) == 5 && v.UncheckedAt(1) == 5 && v.Data() == &v[0]);
+    v.At(2) = 7;
+    const Vector<int>& cv = v;
+    assert(cv.At(2) == 7 && cv.UncheckedAt(2) == 7 && cv.Data() == v.begin());
+    try {
+        cv.At(3);
+        assert(false && "Exception is expected");
+    } catch (const std::out_of_range&) {
+    }
+    try {
+        v.At(std::numeric_limits<size_t>::max());
+        assert(false && "Exception is expected");
+    } catch (const std::out_of_range&) {
+    }
+    // Data() пустого вектора допустимо вызывать, а At() — нет
+    Vector<int> empty;
+    assert(empty.Data() == nullptr);
+    try {
+        empty.At(0);
+        assert(false && "Exception is expected");
+    } catch (const std::out_of_range&) {
+    }
+}
+
+void Test28() {
+    {
+        // Вставка в конец, в том числе в пустой вектор
+        Vector<int> v;
+        v.Emplace(v.end(), 2);
+        v.Insert(v.begin(), 1);
+        v.Insert(v.end(), 3);
+        assert(v.Size() == 3 && v[0] == 1 && v[1] == 2 && v[2] == 3);
+        SmallVector<int, 2> sv;
+        sv.Emplace(sv.end(), 1);
+        sv.Emplace(sv.end(), 2);
+        sv.Emplace(sv.end(), 3);
+        assert(sv.Size() == 3 && sv[2] == 3);
+    }
+    {
+        // Хвост сдвигается один раз, новый элемент создаётся прямо на месте без временного объекта
+        Vector<ShiftObj> v;
+        v.Reserve(5);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        ShiftObj::num_move_constructed = 0;
+        ShiftObj::num_move_assigned = 0;
+        v.Emplace(v.begin() + 1, 10);
+        assert(ShiftObj::num_move_constructed == 1 && ShiftObj::num_move_assigned == 2);
+        assert(v.Size() == 5 && v[0].id == 0 && v[1].id == 10 && v[2].id == 1 && v[4].id == 3);
+    }
+    {
+        // Аргумент ссылается на сдвигаемый элемент
+        Vector<std::string> v;
+        v.Reserve(4);
+        for (const char* s : {"first long string that does not fit into SSO", "second", "third long string for aliasing"}) {
+            v.EmplaceBack(s);
+        }
+        v.Emplace(v.begin(), v[2]);
+        assert(v.Size() == 4 && v[0] == v[3] && v[1][0] == 'f' && v[2] == "second");
+
+        Vector<RelocatableObj> r;
+        r.Reserve(3);
+        r.EmplaceBack(1);
+        r.EmplaceBack(2);
+        r.Emplace(r.begin(), r[1]);
+        assert(r.Size() == 3 && r[0].id == 2 && r[1].id == 1 && r[2].id == 2);
+
+        SmallVector<std::string, 4> sv;
+        sv.EmplaceBack("a");
+        sv.EmplaceBack("b");
+        sv.Emplace(sv.begin(), sv[1]);
+        assert(sv.Size() == 3 && sv[0] == "b" && sv[1] == "a" && sv[2] == "b");
+    }
+    {
+        // Исключение при создании элемента оставляет вектор прежним
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(4);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        Obj bad(3);
+        bad.throw_on_copy = true;
+        try {
+            v.Emplace(v.begin(), bad);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v[0].id == 1 && v[1].id == 2);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+}
+
+void Test29() {
+    {
+        FlatSet<int> set{5, 1, 3};
+        assert(set.Insert(2).second && !set.Insert(3).second);
+        assert(set.Size() == 4 && std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(5) && !set.Contains(4) && set.Find(4) == set.end() && *set.Find(2) == 2);
+        assert(*set.LowerBound(4) == 5 && *set.UpperBound(2) == 3 && set.LowerBound(6) == set.end());
+        const int values[] = {9, 1, 7, 7, 0, 4};
+        set.InsertUnsorted(values);
+        const int expected[] = {0, 1, 2, 3, 4, 5, 7, 9};
+        assert(set.Size() == std::size(expected) && std::equal(set.begin(), set.end(), std::begin(expected)));
+        assert(set.Erase(7) == 1 && set.Erase(7) == 0 && !set.Contains(7));
+        set.Erase(set.begin());
+        assert(*set.begin() == 1 && set.Count(1) == 1);
+    }
+    {
+        // Поиск в отсортированном массиве и в снимке Эйтцингера совпадает с std::lower_bound
+        for (size_t size : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+            Vector<int> keys;
+            for (size_t i = 0; i < size; ++i) {
+                keys.PushBack(static_cast<int>(i * 3));
+            }
+            FlatSet<int> set(keys.begin(), keys.end());
+            const FlatSet<int>::Snapshot snapshot = set.MakeSnapshot();
+            assert(snapshot.Size() == size);
+            for (int key = -1; key <= static_cast<int>(size * 3); ++key) {
+                const int* expected = std::lower_bound(keys.begin(), keys.end(), key);
+                assert(set.LowerBound(key) - set.begin() == expected - keys.begin());
+                assert(set.UpperBound(key - 1) - set.begin() == expected - keys.begin());
+                const int* found = snapshot.LowerBound(key);
+                assert(expected == keys.end() ? found == nullptr : found != nullptr && *found == *expected);
+                assert(snapshot.Contains(key) == (key >= 0 && key % 3 == 0 && key < static_cast<int>(size * 3)));
+            }
+        }
+    }
+    {
+        // Из равных ключей InsertUnsorted оставляет прежний элемент или первый в диапазоне
+        FlatMap<int, std::string> map;
+        map[2] = "two";
+        const std::pair<int, std::string> pairs[] = {{3, "three"}, {2, "second two"}, {1, "one"}, {3, "second three"}};
+        map.InsertUnsorted(pairs);
+        assert(map.Size() == 3 && map.At(1) == "one" && map.At(2) == "two" && map.At(3) == "three");
+        assert(!map.TryEmplace(1, "uno").second && map.At(1) == "one");
+        assert(!map.InsertOrAssign(1, "uno").second && map.At(1) == "uno");
+        assert(map.InsertOrAssign(0, "zero").second && map.begin()->second == "zero");
+        map.Find(3)->second += "!";
+        assert(map.At(3) == "three!");
+        try {
+            map.At(4);
+            assert(false && "Exception is expected");
+        } catch (const std::out_of_range&) {
+        }
+        const auto snapshot = map.MakeSnapshot();
+        assert(snapshot.Find(3) != nullptr && snapshot.Find(3)->second == "three!" && snapshot.Find(4) == nullptr);
+        assert(map.Erase(0) == 1 && map.Size() == 3);
+        const FlatMap<int, std::string> copy = map;
+        assert(copy == map && copy.Find(2)->second == "two");
+    }
+    {
+        // Пользовательский порядок
+        FlatSet<std::string, std::greater<std::string>> set{"b", "a", "c"};
+        assert(*set.begin() == "c" && *set.LowerBound("bb") == "b" && set.MakeSnapshot().Contains("a"));
+    }
+    {
+        // Исключение из сравнения на любом шаге сортировки или слияния оставляет прежнее содержимое
+        static size_t comparisons_left = 0;
+        struct ThrowingLess {
+            bool operator()(const std::string& lhs, const std::string& rhs) const {
+                if (comparisons_left > 0 && --comparisons_left == 0) {
+                    throw std::runtime_error("comparison failed");
+                }
+                return lhs < rhs;
+            }
+        };
+        const std::string values[] = {"d", "a", "f", "c", "a", "g"};
+        for (size_t point = 1;; ++point) {
+            FlatSet<std::string, ThrowingLess> set{"b", "c", "e"};
+            comparisons_left = point;
+            try {
+                set.InsertUnsorted(values);
+            } catch (const std::runtime_error&) {
+                assert(set.Size() == 3 && set.Contains("b") && set.Contains("c") && set.Contains("e"));
+                continue;
+            }
+            comparisons_left = 0;
+            const std::string expected[] = {"a", "b", "c", "d", "e", "f", "g"};
+            assert(std::equal(set.begin(), set.end(), std::begin(expected), std::end(expected)));
+            break;
+        }
+    }
+}
+
+void Test30() {
+    {
+        CowVector<std::string> config{"alpha", "beta", "gamma"};
+        CowVector<std::string> worker = config;
+        const auto snapshot = worker.GetSnapshot();
+        // Копии и снимок разделяют один буфер
+        assert(worker.IsShared() && worker.begin() == config.begin() && snapshot->begin() == config.begin());
+        assert(worker == config && worker[1] == "beta");
+
+        // Изменение копирует буфер, остальные владельцы видят прежние данные
+        worker[1] = "BETA";
+        assert(worker.begin() != config.begin() && config[1] == "beta" && (*snapshot)[1] == "beta");
+        assert(worker != config && !worker.IsShared());
+        worker.EmplaceBack("delta");
+        worker.Erase(worker.begin());
+        assert(worker.Size() == 3 && worker[0] == "BETA" && worker[2] == "delta");
+
+        // Аргументы могут ссылаться на разделяемый буфер
+        CowVector<std::string> other = config;
+        other.EmplaceBack(other[0]);
+        other.Insert(other.begin(), other[2]);
+        assert(other.Size() == 5 && other[0] == "gamma" && other[4] == "alpha" && config.Size() == 3);
+
+        // Аргумент читается, пока вектор владеет прежним буфером, даже если последняя другая копия
+        // отпускает этот буфер во время вызова
+        struct ReleasingCopy {
+            operator std::string() const {
+                *owner = CowVector<std::string>();
+                return *source;
+            }
+            CowVector<std::string>* owner;
+            const std::string* source;
+        };
+        CowVector<std::string> released = config;
+        CowVector<std::string> kept = released;
+        kept.EmplaceBack(ReleasingCopy{&released, &std::as_const(kept)[1]});
+        assert(kept.Size() == 4 && kept[3] == "beta" && released.Empty());
+        released = kept;
+        kept.Emplace(kept.begin(), ReleasingCopy{&released, &std::as_const(kept)[2]});
+        assert(kept.Size() == 5 && kept[0] == "gamma" && kept[4] == "beta" && released.Empty());
+
+        CowVector<std::string> erased = config;
+        auto it = erased.Erase(erased.begin() + 1);
+        assert(erased.Size() == 2 && *it == "gamma" && config.Size() == 3);
+        erased = config;
+        erased.PopBack();
+        assert(erased.Size() == 2 && erased[1] == "beta" && config.Size() == 3);
+        erased = config;
+        erased.Clear();
+        assert(erased.Empty() && config.Size() == 3);
+    }
+    {
+        // Пустой вектор не выделяет памяти, пока не изменён
+        CowVector<int> empty;
+        CowVector<int> copy = empty;
+        assert(empty.Empty() && empty.IsShared() && empty.GetSnapshot()->Size() == 0);
+        empty.PopBack();
+        assert(empty.Empty());
+        copy.Resize(3);
+        assert(copy.Size() == 3 && empty.Empty());
+        CowVector<int> moved = std::move(copy);
+        assert(moved.Size() == 3 && copy.Empty());
+        moved.Mutable().PushBack(4);
+        assert(moved.Size() == 4 && moved[3] == 4);
+    }
+    {
+        // Запись через ссылку, полученную до копирования, не попадает в копию и снимок
+        CowVector<int> v{1, 2, 3};
+        int& r = v[0];
+        const CowVector<int> copy = v;
+        const auto snapshot = v.GetSnapshot();
+        CowVector<int> assigned;
+        assigned = v;
+        r = 10;
+        assert(std::as_const(v)[0] == 10 && copy[0] == 1 && (*snapshot)[0] == 1 && std::as_const(assigned)[0] == 1);
+        assert(!v.IsShared() && !copy.IsShared() && copy.begin() != v.begin());
+
+        // Копии неразделяемого буфера снова разделяются между собой
+        const CowVector<int> copy_of_copy = copy;
+        assert(copy_of_copy.begin() == copy.begin());
+    }
+    {
+        // Аллокатор сохраняется, пока вектор пуст и не владеет буфером: после Clear разделяемого буфера,
+        // после перемещения и в векторе, созданном только с аллокатором
+        using Alloc = ArenaAllocator<int, false>;
+        {
+            CowVector<int, Alloc> v(3, Alloc(2));
+            const CowVector<int, Alloc> copy = v;
+            v.Clear();
+            assert(v.Empty() && v.GetAllocator().id == 2 && copy.Size() == 3);
+            v.PushBack(1);
+            assert(v.GetSnapshot()->GetAllocator().id == 2);
+            CowVector<int, Alloc> moved = std::move(v);
+            v.PushBack(2);
+            assert(v.GetSnapshot()->GetAllocator().id == 2 && moved.GetAllocator().id == 2);
+            CowVector<int, Alloc> empty(Alloc(3));
+            empty.EmplaceBack(1);
+            assert(empty.GetSnapshot()->GetAllocator().id == 3 && Alloc::num_allocations[3] == 1);
+            empty.Swap(moved);
+            assert(empty.GetAllocator().id == 2 && moved.GetAllocator().id == 3);
+        }
+        assert(Alloc::num_allocations[2] == 0 && Alloc::num_allocations[3] == 0);
+    }
+    {
+        // Снимки берутся и освобождаются из многих потоков, пока писатель меняет свою копию
+        CowVector<int> table(1000);
+        std::atomic<bool> done = false;
+        Vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.EmplaceBack([&table, &done] {
+                const CowVector<int> view = table;
+                while (!done.load()) {
+                    const auto snapshot = view.GetSnapshot();
+                    assert(snapshot->Size() == 1000 && (*snapshot)[999] == 0);
+                }
+            });
+        }
+        CowVector<int> writer = table;
+        for (int i = 0; i < 1000; ++i) {
+            writer[i] = i;
+        }
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(writer[999] == 999 && table[999] == 0);
+    }
+}
+
+void Test31() {
+    using PoolVector = Vector<int, PoolAllocator<int>>;
+    {
+        // Освобождённый буфер достаётся следующему вектору того же класса размера
+        BufferPool pool;
+        const PoolAllocator<int> alloc(pool);
+        const int* buffer = nullptr;
+        {
+            PoolVector v(alloc);
+            v.Reserve(100);
+            assert(v.Capacity() == 128);
+            buffer = v.begin();
+        }
+        assert(pool.CachedBytes() == 128 * sizeof(int));
+        PoolVector v(alloc);
+        v.Resize(120);
+        assert(v.begin() == buffer && pool.CachedBytes() == 0);
+        // Рост возвращает прежний буфер в пул
+        v.Resize(200);
+        assert(v.Capacity() == 256 && pool.CachedBytes() == 128 * sizeof(int));
+        PoolVector copy(v);
+        assert(copy == v && copy.GetAllocator() == alloc);
+        PoolVector small(alloc);
+        small.Reserve(65);
+        assert(small.begin() == buffer);
+        pool.Trim();
+        assert(pool.CachedBytes() == 0);
+    }
+    {
+        // Пул не хранит больше max_cached_bytes байт
+        BufferPool pool(1024);
+        {
+            Vector<int, PoolAllocator<int>> large(1000, PoolAllocator<int>(pool));
+            Vector<int, PoolAllocator<int>> small(10, PoolAllocator<int>(pool));
+        }
+        assert(pool.CachedBytes() == 64);
+    }
+    {
+        // По умолчанию каждый поток пользуется своим пулом; буфер можно освободить в другом потоке
+        const size_t cached = BufferPool::ThreadLocal()->CachedBytes();
+        PoolVector from_thread;
+        std::thread([&from_thread] {
+            PoolVector v(500);
+            from_thread = std::move(v);
+            PoolVector temporary(500);
+        }).join();
+        assert(from_thread.Size() == 500 && BufferPool::ThreadLocal()->CachedBytes() == cached);
+        from_thread = PoolVector();
+        assert(BufferPool::ThreadLocal()->CachedBytes() == cached + 512 * sizeof(int));
+        PoolVector reused(300);
+        assert(BufferPool::ThreadLocal()->CachedBytes() == cached);
+    }
+}
+
+#if __cplusplus >= 202002L
+// Таблица квадратов, построенная на этапе компиляции
+constexpr StaticVector<int, 16> MakeSquares() {
+    StaticVector<int, 16> squares;
+    for (int i = 9; i >= 0; i -= 3) {
+        squares.PushBack(i * i);
+    }
+    squares.Insert(squares.begin(), 100);
+    squares.Emplace(squares.begin() + 2, 50);
+    squares.Erase(squares.begin() + 1);
+    StaticVector<int, 16> copy = squares;
+    copy.Resize(copy.Size() + 1);
+    return copy;
+}
+
+constexpr StaticVector<int, 16> SQUARES = MakeSquares();
+static_assert(SQUARES.Size() == 6 && SQUARES[0] == 100 && SQUARES[1] == 50 && SQUARES[2] == 36 && SQUARES[5] == 0);
+#endif
+
+void Test32() {
+    {
+        StaticVector<std::string, 4> v{"b", "d"};
+        static_assert(StaticVector<std::string, 4>::Capacity() == 4);
+        v.Emplace(v.begin(), v[1]);
+        v.Insert(v.begin() + 2, "c");
+        assert(v.Size() == 4 && v[0] == "d" && v[1] == "b" && v[2] == "c" && v[3] == "d");
+        try {
+            v.EmplaceBack("e");
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        assert(v.TryEmplaceBack("e") == nullptr && v.Size() == 4);
+        v.Erase(v.begin(), v.begin() + 2);
+        assert(v.Size() == 2 && v[0] == "c" && v.TryEmplaceBack(v[0]) != nullptr && v[2] == "c");
+
+        StaticVector<std::string, 4> other{"x"};
+        other.Swap(v);
+        assert(other.Size() == 3 && v.Size() == 1 && v[0] == "x" && other[2] == "c");
+        v = other;
+        assert(v == other);
+        StaticVector<std::string, 4> moved(std::move(v));
+        assert(moved == other);
+        moved.Resize(1);
+        assert(moved.Size() == 1 && moved.At(0) == "c");
+        moved.PopBack();
+        moved.PopBack();
+        assert(moved.Size() == 0);
+    }
+    {
+        // Элементы создаются внутри объекта, без кучи
+        Obj::ResetCounters();
+        {
+            StaticVector<Obj, 8> v(3);
+            v.EmplaceBack(5);
+            v.Emplace(v.begin(), 7);
+            assert(v.Size() == 5 && v[0].id == 7 && v[4].id == 5);
+            const void* bytes = &v;
+            assert(static_cast<const void*>(v.Data()) >= bytes && static_cast<const void*>(v.Data() + 8) <= static_cast<const void*>(&v + 1));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+#if __cplusplus >= 202002L
+    assert(std::equal(SQUARES.begin(), SQUARES.end(), std::begin({100, 50, 36, 9, 0, 0})));
+#endif
+}
+
+void Test33() {
+    {
+        Vector<int> v;
+        v.PushBack(1);
+        v.PushBack(2);
+        {
+            auto sink = v.BackInserter(3);
+            assert(v.Capacity() >= 5);
+            for (int i = 3; i <= 100; ++i) {
+                sink.PushBack(i);
+            }
+            assert(v.Size() == 2 && sink.Pending() == 98);
+            int* raw = sink.Acquire(1000);
+            for (int i = 0; i < 1000; ++i) {
+                raw[i] = 101 + i;
+            }
+            sink.Produced(1000);
+            sink.Commit();
+            assert(sink.Pending() == 0);
+        }
+        assert(v.Size() == 1100);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i + 1));
+        }
+        {
+            auto sink = v.BackInserter();
+            const int more[] = {1, 2, 3};
+            std::copy(std::begin(more), std::end(more), sink.Inserter());
+            // Без Commit добавленное отбрасывается
+        }
+        assert(v.Size() == 1100 && v[1099] == 1100);
+    }
+    {
+        // Исключение при создании элемента разрушает незафиксированные элементы, зафиксированные остаются
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        try {
+            auto sink = v.BackInserter();
+            sink.EmplaceBack(1);
+            sink.Commit();
+            for (int i = 0; i < 10; ++i) {
+                sink.EmplaceBack(i);
+            }
+            Obj::default_construction_throw_countdown = 1;
+            sink.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 1 && v[0].id == 1 && Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        // Рост буфера переносит незафиксированные элементы, Rollback разрушает их, и приёмник можно использовать дальше
+        Vector<Obj> v;
+        Obj::ResetCounters();
+        auto sink = v.BackInserter(2);
+        sink.EmplaceBack(1);
+        sink.EmplaceBack(2);
+        sink.EmplaceBack(3);
+        assert(v.Capacity() >= 3 && v.Size() == 0 && sink.Pending() == 3);
+        sink.Rollback();
+        assert(Obj::GetAliveObjectCount() == 0);
+        sink.EmplaceBack(4);
+        sink.Commit();
+        assert(v.Size() == 1 && v[0].id == 4);
+    }
+    {
+        // Перемещённый приёмник ничего не фиксирует, а новый владелец продолжает пакет
+        Vector<int> v;
+        auto sink = v.BackInserter(2);
+        sink.PushBack(1);
+        auto moved = std::move(sink);
+        sink.Commit();
+        assert(sink.Pending() == 0 && v.Size() == 0 && moved.Pending() == 1);
+        moved.PushBack(2);
+        moved.Commit();
+        sink.Commit();
+        assert(v.Size() == 2 && v[0] == 1 && v[1] == 2);
+    }
+}
+
+// Вектор из size элементов со значениями 0, 1, ... и ёмкостью capacity
+template <typename T>
+Vector<T, CountingAllocator<T>> MakeTracked(size_t size, size_t capacity) {
+    Vector<T, CountingAllocator<T>> v;
+    v.Reserve(capacity);
+    for (size_t i = 0; i < size; ++i) {
+        v.EmplaceBack(static_cast<int>(i));
+    }
+    return v;
+}
+
+template <typename T>
+bool HasValues(const Vector<T, CountingAllocator<T>>& v, size_t size) {
+    if (v.Size() != size) {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (v[i].value != static_cast<int>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Test34() {
+    using Tracked = Vector<TrackedObj, CountingAllocator<TrackedObj>>;
+    using ThrowingTracked = Vector<ThrowingMoveTrackedObj, CountingAllocator<ThrowingMoveTrackedObj>>;
+    // Бюджеты операций: увеличение любого счётчика — регрессия производительности
+    {
+        Tracked v = MakeTracked<TrackedObj>(10, 10);
+        OperationCost cost = Measure([&] { v.Reserve(100); });
+        assert(cost.allocations == 1 && cost.deallocations == 1);
+        assert(cost.moves == 10 && cost.copies == 0 && cost.destructions == 10);
+        cost = Measure([&] { v.Reserve(50); });
+        assert(cost.allocations == 0 && cost.moves == 0);
+
+        ThrowingTracked t = MakeTracked<ThrowingMoveTrackedObj>(10, 10);
+        cost = Measure([&] { t.Reserve(100); });
+        assert(cost.allocations == 1 && cost.copies == 10 && cost.moves == 0);
+    }
+    {
+        Tracked v = MakeTracked<TrackedObj>(10, 11);
+        OperationCost cost = Measure([&] { v.EmplaceBack(10); });
+        assert(cost.allocations == 0 && cost.constructions == 1 && cost.moves == 0 && cost.copies == 0);
+        cost = Measure([&] { v.EmplaceBack(11); });
+        assert(cost.allocations == 1 && cost.constructions == 1 && cost.moves == 11 && cost.copies == 0);
+
+        // Рост с нуля: логарифмическое число выделений и амортизированно O(1) переносов на элемент
+        const size_t count = 1000;
+        Tracked grown;
+        cost = Measure([&] {
+            for (size_t i = 0; i < count; ++i) {
+                grown.EmplaceBack(static_cast<int>(i));
+            }
+        });
+        assert(cost.allocations <= 11 && cost.moves < 2 * count && cost.copies == 0);
+    }
+    {
+        // Вставка в середину при наличии места сдвигает хвост один раз; при нехватке — только переносит элементы
+        Tracked v = MakeTracked<TrackedObj>(10, 20);
+        OperationCost cost = Measure([&] { v.Emplace(v.begin() + 3, 100); });
+        assert(cost.allocations == 0 && cost.constructions == 1 && cost.copies == 0);
+        assert(cost.moves <= 2 && cost.move_assignments == 6 && cost.copy_assignments == 0);
+
+        Tracked full = MakeTracked<TrackedObj>(10, 10);
+        cost = Measure([&] { full.Emplace(full.begin() + 3, 100); });
+        assert(cost.allocations == 1 && cost.constructions == 1 && cost.moves == 10);
+        assert(cost.copies == 0 && cost.move_assignments == 0);
+    }
+    {
+        Tracked v = MakeTracked<TrackedObj>(10, 10);
+        OperationCost cost = Measure([&] { v.Erase(v.begin() + 3); });
+        assert(cost.allocations == 0 && cost.move_assignments == 6 && cost.destructions == 1);
+        assert(cost.moves == 0 && cost.copies == 0);
+        cost = Measure([&] { v.Erase(v.begin() + 2, v.begin() + 5); });
+        assert(cost.allocations == 0 && cost.move_assignments == 4 && cost.destructions == 3);
+    }
+    {
+        const Tracked source = MakeTracked<TrackedObj>(10, 10);
+        // В вектор достаточной ёмкости: присваивание существующим элементам и копирование остальных
+        Tracked roomy = MakeTracked<TrackedObj>(5, 20);
+        OperationCost cost = Measure([&] { roomy = source; });
+        assert(cost.allocations == 0 && cost.copy_assignments == 5 && cost.copies == 5);
+        Tracked longer = MakeTracked<TrackedObj>(15, 20);
+        cost = Measure([&] { longer = source; });
+        assert(cost.allocations == 0 && cost.copy_assignments == 10 && cost.destructions == 5 && cost.copies == 0);
+        // В вектор меньшей ёмкости: одно выделение под копию
+        Tracked small = MakeTracked<TrackedObj>(2, 2);
+        cost = Measure([&] { small = source; });
+        assert(cost.allocations == 1 && cost.copies == 10 && cost.copy_assignments == 0);
+        // Перемещение забирает буфер без операций над элементами
+        Tracked moved = MakeTracked<TrackedObj>(3, 3);
+        Tracked donor = source;
+        cost = Measure([&] { moved = std::move(donor); });
+        assert(cost.allocations == 0 && cost.copies == 0 && cost.moves == 0 && cost.destructions == 3);
+        assert(HasValues(moved, 10));
+    }
+    // Отказ в каждой точке: без утечек, а для операций со строгой гарантией — без изменения вектора
+    {
+        auto make_full = [] {
+            return MakeTracked<TrackedObj>(8, 8);
+        };
+        auto make_throwing_full = [] {
+            return MakeTracked<ThrowingMoveTrackedObj>(8, 8);
+        };
+        auto unchanged = [](const auto& v, bool failed) {
+            assert(HasValues(v, 8) && v.Capacity() == (failed ? 8 : 64));
+        };
+        size_t points = InjectFailures(make_full, [](Tracked& v) { v.Reserve(64); }, unchanged);
+        assert(points == 1);
+        points = InjectFailures(make_throwing_full, [](ThrowingTracked& v) { v.Reserve(64); }, unchanged);
+        assert(points == 9);
+
+        auto unchanged_or_appended = [](const auto& v, bool failed) {
+            if (failed) {
+                assert(HasValues(v, 8) && v.Capacity() == 8);
+            } else {
+                assert(HasValues(v, 9));
+            }
+        };
+        points = InjectFailures(make_full, [](Tracked& v) { v.EmplaceBack(8); }, unchanged_or_appended);
+        assert(points == 2);
+        points = InjectFailures(make_throwing_full, [](ThrowingTracked& v) { v.EmplaceBack(8); },
+                                unchanged_or_appended);
+        assert(points == 10);
+
+        auto unchanged_or_inserted = [](const Tracked& v, bool failed) {
+            if (failed) {
+                assert(HasValues(v, 8));
+            } else {
+                assert(v.Size() == 9 && v[3].value == 100 && v[4].value == 3);
+            }
+        };
+        points = InjectFailures(make_full, [](Tracked& v) { v.Emplace(v.begin() + 3, 100); }, unchanged_or_inserted);
+        assert(points == 2);
+    }
+    {
+        // Операции с базовой гарантией: после отказа элементы и память вектора согласованы
+        auto consistent = [](const auto& v, bool) {
+            for (const auto& item : v) {
+                assert(item.value >= 0);
+            }
+        };
+        auto make_throwing = [] {
+            return MakeTracked<ThrowingMoveTrackedObj>(8, 16);
+        };
+        size_t points = InjectFailures(
+            make_throwing, [](ThrowingTracked& v) { v.Emplace(v.begin() + 2, 100); }, consistent);
+        assert(points > 0);
+        points = InjectFailures(make_throwing, [](ThrowingTracked& v) { v.Erase(v.begin() + 2); }, consistent);
+        assert(points > 0);
+        points = InjectFailures(make_throwing, [](ThrowingTracked& v) { v.Resize(40); }, consistent);
+        assert(points > 0);
+        const ThrowingTracked source = MakeTracked<ThrowingMoveTrackedObj>(12, 12);
+        points = InjectFailures(make_throwing, [&](ThrowingTracked& v) { v = source; }, consistent);
+        assert(points > 0);
+        points = InjectFailures(
+            make_throwing, [](ThrowingTracked& v) { ThrowingTracked copy(v); }, consistent);
+        assert(points == 9);
+        points = InjectFailures(
+            make_throwing, [&](ThrowingTracked& v) { v.Insert(v.begin() + 1, source.begin(), source.end()); },
+            consistent);
+        assert(points > 0);
+    }
+}
+
+void Test35() {
+    using Tracked = Vector<TrackedObj, CountingAllocator<TrackedObj>>;
+    using ThrowingTracked = Vector<ThrowingMoveTrackedObj, CountingAllocator<ThrowingMoveTrackedObj>>;
+    {
+        // Рост через Resize(Size() + k) геометрический, как у EmplaceBack
+        Tracked v;
+        OperationCost cost = Measure([&] {
+            for (size_t i = 0; i < 1000; ++i) {
+                v.Resize(v.Size() + 1);
+            }
+        });
+        assert(v.Size() == 1000 && cost.allocations <= 11 && cost.moves < 2000);
+        Vector<int, CountingAllocator<int>> ints;
+        cost = Measure([&] {
+            for (size_t i = 0; i < 1000; ++i) {
+                ints.Resize(ints.Size() + 7);
+            }
+        });
+        assert(ints.Size() == 7000 && cost.allocations <= 15);
+    }
+    {
+        // Перевыделение в Emplace переносит элементы так же, как Reserve: бросающее перемещение заменяется копированием
+        ThrowingTracked v = MakeTracked<ThrowingMoveTrackedObj>(10, 10);
+        const OperationCost cost = Measure([&] { v.Emplace(v.begin() + 3, 100); });
+        assert(cost.allocations == 1 && cost.constructions == 1 && cost.copies == 10 && cost.moves == 0);
+        assert(v.Size() == 11 && v[3].value == 100 && v[4].value == 3 && v[10].value == 9);
+    }
+    {
+        // Строгая гарантия перевыделения в Emplace и Insert: при отказе вектор не меняется
+        auto make_full = [] {
+            return MakeTracked<ThrowingMoveTrackedObj>(8, 8);
+        };
+        auto unchanged_or_inserted = [](const ThrowingTracked& v, bool failed) {
+            if (failed) {
+                assert(HasValues(v, 8) && v.Capacity() == 8);
+            } else {
+                assert(v.Size() == 9 && v[2].value == 100 && v[3].value == 2);
+            }
+        };
+        size_t points = InjectFailures(
+            make_full, [](ThrowingTracked& v) { v.Emplace(v.begin() + 2, 100); }, unchanged_or_inserted);
+        assert(points == 10);
+        points = InjectFailures(
+            make_full, [](ThrowingTracked& v) { v.Insert(v.begin() + 2, ThrowingMoveTrackedObj(100)); },
+            unchanged_or_inserted);
+        assert(points == 11);
+        // Аргумент, ссылающийся на элемент самого вектора, остаётся действительным при перевыделении
+        ThrowingTracked v = make_full();
+        v.Emplace(v.begin() + 2, v[7]);
+        assert(v.Size() == 9 && v[2].value == 7 && v[8].value == 7);
+    }
+}
+
+void Test36() {
+    using Tracked = Vector<TrackedObj, CountingAllocator<TrackedObj>>;
+    using ThrowingTracked = Vector<ThrowingMoveTrackedObj, CountingAllocator<ThrowingMoveTrackedObj>>;
+    {
+        // Пакетная вставка без перевыделения переносит каждый элемент хвоста один раз и присваивает
+        // новые значения элементам, оказавшимся в пропуске
+        const TrackedObj value(100);
+        Tracked v = MakeTracked<TrackedObj>(10, 20);
+        OperationCost cost = Measure([&] { v.Insert(v.begin() + 3, 4, value); });
+        assert(cost.allocations == 0 && cost.moves == 4 && cost.move_assignments == 3);
+        assert(cost.copy_assignments == 4 && cost.copies == 0 && cost.destructions == 0);
+        assert(v.Size() == 14 && v[3].value == 100 && v[6].value == 100 && v[7].value == 3 && v[13].value == 9);
+
+        // Пропуск длиннее хвоста: часть новых элементов создаётся за прежним концом
+        Tracked shorter = MakeTracked<TrackedObj>(10, 20);
+        cost = Measure([&] { shorter.Insert(shorter.begin() + 8, 4, value); });
+        assert(cost.allocations == 0 && cost.moves == 2 && cost.move_assignments == 0);
+        assert(cost.copy_assignments == 2 && cost.copies == 2);
+        assert(shorter.Size() == 14 && shorter[11].value == 100 && shorter[12].value == 8);
+
+        // Диапазон из самого вектора вставляется через временную копию
+        Tracked self = MakeTracked<TrackedObj>(6, 20);
+        self.Insert(self.begin() + 1, self.begin() + 3, self.end());
+        const int expected[] = {0, 3, 4, 5, 1, 2, 3, 4, 5};
+        assert(self.Size() == 9);
+        for (size_t i = 0; i < self.Size(); ++i) {
+            assert(self[i].value == expected[i]);
+        }
+    }
+    {
+        // Отказ при вставке без перевыделения: для nothrow-перемещаемых типов вектор не меняется,
+        // для типов с бросающим перемещением сохраняется размер, и в обоих случаях нет утечек
+        const TrackedObj value(100);
+        const Tracked source = MakeTracked<TrackedObj>(3, 3);
+        auto make_roomy = [] {
+            return MakeTracked<TrackedObj>(8, 16);
+        };
+        auto unchanged_or_inserted = [](const Tracked& v, bool failed) {
+            if (failed) {
+                assert(HasValues(v, 8) && v.Capacity() == 16);
+            } else {
+                assert(v.Size() == 11 && v[1].value == 1 && v[5].value == 2 && v[10].value == 7);
+            }
+        };
+        size_t points = InjectFailures(
+            make_roomy, [&](Tracked& v) { v.Insert(v.begin() + 2, 3, value); }, unchanged_or_inserted);
+        assert(points == 3);
+        points = InjectFailures(
+            make_roomy, [&](Tracked& v) { v.Insert(v.begin() + 2, source.begin(), source.end()); },
+            unchanged_or_inserted);
+        assert(points == 3);
+        points = InjectFailures(
+            make_roomy, [&](Tracked& v) { v.Insert(v.begin() + 7, 3, value); }, [](const Tracked& v, bool failed) {
+                assert(failed ? HasValues(v, 8) : v.Size() == 11 && v[10].value == 7);
+            });
+        assert(points == 3);
+
+        const ThrowingMoveTrackedObj throwing_value(100);
+        const ThrowingTracked throwing_source = MakeTracked<ThrowingMoveTrackedObj>(3, 3);
+        auto make_throwing = [] {
+            return MakeTracked<ThrowingMoveTrackedObj>(8, 16);
+        };
+        auto same_size = [](const ThrowingTracked& v, bool failed) {
+            assert(v.Size() == (failed ? 8 : 11) && v.Capacity() == 16);
+        };
+        for (size_t index : {0, 2, 6, 8}) {
+            points = InjectFailures(
+                make_throwing, [&](ThrowingTracked& v) { v.Insert(v.begin() + index, 3, throwing_value); },
+                same_size);
+            assert(points > 0);
+            points = InjectFailures(
+                make_throwing,
+                [&](ThrowingTracked& v) { v.Insert(v.begin() + index, throwing_source.begin(), throwing_source.end()); },
+                same_size);
+            assert(points > 0);
+        }
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -387,6 +2577,39 @@ int main() {
         Test3();
         Test4();
         Test5();
+        Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+#if defined(__linux__)
+        Test19();
+        Test20();
+        Test21();
+        Test23();
+#endif
+        Test22();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
+        Test36();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
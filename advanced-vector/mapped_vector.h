@@ -0,0 +1,355 @@
+#pragma once
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// Режим открытия файла MappedVector
+enum class MappedMode {
+    CREATE,      // создать пустой файл (существующий файл усекается)
+    READ_WRITE,  // открыть существующий файл для чтения и записи
+    READ_ONLY,   // открыть существующий файл только для чтения
+};
+
+// Заголовок файла MappedVector. Элементы хранятся сразу за заголовком
+struct MappedHeader {
+    static constexpr uint64_t MAGIC = 0x50414d4345564100;  // "\0AVECMAP"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t elem_size;
+    uint64_t size;      // число элементов
+    uint64_t capacity;  // число элементов, под которые размечен файл
+};
+
+// Вектор тривиально копируемых элементов, хранящийся в файле, отображённом в память (Linux).
+// Открытие файла не читает данные: страницы подгружаются ядром при первом обращении,
+// поэтому большой набор данных доступен сразу после запуска. Рост буфера увеличивает файл через ftruncate
+// и расширяет отображение через mremap; изменения попадают в файл без явного сохранения
+// (Sync дожидается их записи на диск). В режиме READ_ONLY отображение защищено от записи,
+// и изменять вектор нельзя. Ошибки системных вызовов выбрасываются как std::system_error,
+// файл неверного формата — как std::runtime_error. Перемещённый вектор пуст, не связан с файлом
+// и доступен только для чтения
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable T");
+    static_assert(alignof(T) <= 64, "MappedVector does not support over-aligned types");
+
+    // Смещение данных от начала файла; выравнивание по строке кэша подходит любому допустимому T
+    static constexpr size_t DATA_OFFSET = 64;
+    static_assert(sizeof(MappedHeader) <= DATA_OFFSET);
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    explicit MappedVector(const std::string& path, MappedMode mode = MappedMode::READ_WRITE)
+        : read_only_(mode == MappedMode::READ_ONLY) {
+        const int flags = mode == MappedMode::CREATE      ? O_RDWR | O_CREAT | O_TRUNC
+                          : mode == MappedMode::READ_ONLY ? O_RDONLY
+                                                          : O_RDWR;
+        const int fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            ThrowSystemError("open");
+        }
+        fd_.reset(fd);
+        if (mode == MappedMode::CREATE) {
+            Truncate(DATA_OFFSET);
+            Map(DATA_OFFSET);
+            MappedHeader& header = Header();
+            header.magic = MappedHeader::MAGIC;
+            header.version = MappedHeader::VERSION;
+            header.elem_size = sizeof(T);
+            header.size = 0;
+            header.capacity = 0;
+        } else {
+            struct stat st {};
+            if (fstat(fd_.get(), &st) != 0) {
+                ThrowSystemError("fstat");
+            }
+            const size_t file_size = static_cast<size_t>(st.st_size);
+            if (file_size < DATA_OFFSET) {
+                throw std::runtime_error("MappedVector: file is too small");
+            }
+            Map(file_size);
+            Validate(file_size);
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::move(other.fd_))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , mapping_size_(std::exchange(other.mapping_size_, 0))
+        , read_only_(std::exchange(other.read_only_, true)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Unmap();
+            fd_ = std::move(rhs.fd_);
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            mapping_size_ = std::exchange(rhs.mapping_size_, 0);
+            read_only_ = std::exchange(rhs.read_only_, true);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Unmap();
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return static_cast<size_t>(Header().size);
+    }
+
+    size_t Capacity() const noexcept {
+        return static_cast<size_t>(Header().capacity);
+    }
+
+    bool IsReadOnly() const noexcept {
+        return read_only_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < Size());
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < Size());
+        assert(!read_only_);
+        return Data()[index];
+    }
+
+    // Увеличивает файл и отображение под new_capacity элементов.
+    // При ошибке вектор остаётся прежним, хотя файл может оказаться длиннее
+    void Reserve(size_t new_capacity) {
+        assert(!read_only_);
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        const size_t new_mapping_size = MappingSize(new_capacity);
+        Truncate(new_mapping_size);
+        void* new_mapping = mremap(mapping_, mapping_size_, new_mapping_size, MREMAP_MAYMOVE);
+        if (new_mapping == MAP_FAILED) {
+            ThrowSystemError("mremap");
+        }
+        mapping_ = new_mapping;
+        mapping_size_ = new_mapping_size;
+        Header().capacity = new_capacity;
+    }
+
+    void Resize(size_t new_size) {
+        assert(!read_only_);
+        if (new_size > Capacity()) {
+            Reserve(NextCapacity(new_size));
+        }
+        if (new_size > Size()) {
+            std::uninitialized_value_construct_n(Data() + Size(), new_size - Size());
+        }
+        Header().size = new_size;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    // Элемент создаётся до роста отображения, поэтому args могут ссылаться на элементы вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        assert(!read_only_);
+        const T value(std::forward<Args>(args)...);
+        const size_t size = Size();
+        if (size == Capacity()) {
+            Reserve(NextCapacity(size + 1));
+        }
+        std::memcpy(static_cast<void*>(Data() + size), static_cast<const void*>(&value), sizeof(T));
+        Header().size = size + 1;
+        return Data()[size];
+    }
+
+    void PopBack() noexcept {
+        assert(!read_only_);
+        if (Size() > 0) {
+            --Header().size;
+        }
+    }
+
+    // Удаляет все элементы, не уменьшая файл
+    void Clear() noexcept {
+        assert(!read_only_);
+        Header().size = 0;
+    }
+
+    // Дожидается записи изменений на диск
+    void Sync() {
+        if (!read_only_ && msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+private:
+    // Закрывает файловый дескриптор при уничтожении
+    class FileDescriptor {
+    public:
+        FileDescriptor() = default;
+
+        FileDescriptor(FileDescriptor&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1)) {
+        }
+
+        FileDescriptor& operator=(FileDescriptor&& rhs) noexcept {
+            if (this != &rhs) {
+                reset(std::exchange(rhs.fd_, -1));
+            }
+            return *this;
+        }
+
+        ~FileDescriptor() {
+            reset(-1);
+        }
+
+        int get() const noexcept {
+            return fd_;
+        }
+
+        void reset(int fd) noexcept {
+            if (fd_ >= 0) {
+                close(fd_);
+            }
+            fd_ = fd;
+        }
+
+    private:
+        int fd_ = -1;
+    };
+
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), std::string("MappedVector: ") + what);
+    }
+
+    static size_t MappingSize(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() - DATA_OFFSET) / sizeof(T)) {
+            throw std::length_error("MappedVector is too long");
+        }
+        return DATA_OFFSET + capacity * sizeof(T);
+    }
+
+    size_t NextCapacity(size_t required) const {
+        MappingSize(required);  // проверяет, что файл такого размера можно адресовать
+        return Growth::NextCapacity(Capacity(), required, sizeof(T));
+    }
+
+    void Truncate(size_t file_size) {
+        if (ftruncate(fd_.get(), static_cast<off_t>(file_size)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+    }
+
+    void Map(size_t size) {
+        const int protection = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* mapping = mmap(nullptr, size, protection, MAP_SHARED, fd_.get(), 0);
+        if (mapping == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        mapping_ = mapping;
+        mapping_size_ = size;
+    }
+
+    void Unmap() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+        }
+    }
+
+    // Проверяет заголовок файла размера file_size. Деструктор не вызывается для объекта,
+    // конструктор которого выбросил исключение, поэтому при ошибке отображение освобождается здесь
+    void Validate(size_t file_size) {
+        const MappedHeader& header = Header();
+        const char* error = nullptr;
+        if (header.magic != MappedHeader::MAGIC) {
+            error = "MappedVector: not a MappedVector file";
+        } else if (header.version != MappedHeader::VERSION) {
+            error = "MappedVector: unsupported file version";
+        } else if (header.elem_size != sizeof(T)) {
+            error = "MappedVector: element size mismatch";
+        } else if (header.size > header.capacity
+                   || header.capacity > (file_size - DATA_OFFSET) / sizeof(T)) {
+            error = "MappedVector: file is truncated";
+        }
+        if (error != nullptr) {
+            Unmap();
+            throw std::runtime_error(error);
+        }
+    }
+
+    // Заголовок изменяется только у вектора, связанного с файлом
+    MappedHeader& Header() noexcept {
+        assert(mapping_ != nullptr);
+        return *static_cast<MappedHeader*>(mapping_);
+    }
+
+    // Перемещённый вектор без отображения читает заголовок пустого вектора
+    const MappedHeader& Header() const noexcept {
+        static constexpr MappedHeader EMPTY{MappedHeader::MAGIC, MappedHeader::VERSION, sizeof(T), 0, 0};
+        return mapping_ != nullptr ? *static_cast<const MappedHeader*>(mapping_) : EMPTY;
+    }
+
+    T* Data() noexcept {
+        return mapping_ != nullptr ? reinterpret_cast<T*>(static_cast<char*>(mapping_) + DATA_OFFSET) : nullptr;
+    }
+
+    const T* Data() const noexcept {
+        return mapping_ != nullptr
+                   ? reinterpret_cast<const T*>(static_cast<const char*>(mapping_) + DATA_OFFSET)
+                   : nullptr;
+    }
+
+    FileDescriptor fd_;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    bool read_only_ = false;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+
+namespace detail {
+
+// Номер старшего единичного бита value (value > 0)
+inline size_t Log2(size_t value) noexcept {
+#if defined(__GNUC__)
+    return std::numeric_limits<unsigned long long>::digits - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+    size_t result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+// Разметка сегментированного хранилища с геометрически растущими сегментами: сегмент k вмещает
+// FirstSegment << k элементов, поэтому k сегментов вмещают FirstSegment * (2^k - 1) элементов,
+// а номер сегмента и смещение в нём вычисляются по индексу за O(1) без обхода таблицы сегментов
+template <size_t FirstSegment>
+struct SegmentLayout {
+    static_assert(FirstSegment > 0 && (FirstSegment & (FirstSegment - 1)) == 0,
+                  "First segment size must be a power of two");
+
+    static constexpr size_t FIRST_SEGMENT = FirstSegment;
+    static constexpr size_t FIRST_SHIFT = [] {
+        size_t shift = 0;
+        while ((size_t{1} << shift) != FirstSegment) {
+            ++shift;
+        }
+        return shift;
+    }();
+    // Столько сегментов хватает, чтобы адресовать любой индекс size_t
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SHIFT;
+
+    static size_t SegmentOf(size_t index) noexcept {
+        return Log2((index >> FIRST_SHIFT) + 1);
+    }
+
+    static size_t SegmentStart(size_t segment) noexcept {
+        return (FirstSegment << segment) - FirstSegment;
+    }
+
+    static size_t SegmentSize(size_t segment) noexcept {
+        return FirstSegment << segment;
+    }
+};
+
+}  // namespace detail
@@ -0,0 +1,439 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "segment_layout.h"
+#include "vector.h"
+
+// Вектор со стабильными ссылками: элементы хранятся в сегментах, размер которых растёт геометрически,
+// а индекс переводится в сегмент и смещение за O(1) по небольшой таблице сегментов.
+// Рост добавляет новый сегмент и не перемещает существующие элементы, поэтому EmplaceBack стоит
+// O(1) без переносов, ссылки и указатели на элементы остаются действительными, а аргументы EmplaceBack
+// могут ссылаться на элементы самого вектора. Интерфейс повторяет Vector; вставка и удаление в середине сдвигают
+// хвост, поэтому стабильны только ссылки на элементы перед позицией изменения.
+// Итераторы, в отличие от ссылок, хранят указатель на таблицу сегментов внутри самого вектора:
+// перемещение вектора и Swap делают их недействительными, хотя сами элементы остаются на месте
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegment = 16>
+class SegmentedVector {
+    using Layout = detail::SegmentLayout<FirstSegment>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Table = T* const*;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Table segments, size_t index) noexcept
+            : segments_(segments)
+            , index_(index) {
+            Seek();
+        }
+
+        // Неконстантный итератор приводится к константному
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+            : segments_(other.segments_)
+            , index_(other.index_)
+            , ptr_(other.ptr_)
+            , segment_end_(other.segment_end_) {
+        }
+
+        reference operator*() const noexcept {
+            return *ptr_;
+        }
+
+        pointer operator->() const noexcept {
+            return ptr_;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        // Внутри сегмента итератор сдвигается как указатель; номер сегмента пересчитывается только на его границе
+        BasicIterator& operator++() noexcept {
+            if (++index_ == segment_end_) {
+                Seek();
+            } else {
+                ++ptr_;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator copy = *this;
+            --*this;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator+(difference_type n, BasicIterator it) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class BasicIterator<!IsConst>;
+
+        void Seek() noexcept {
+            const size_t segment = Layout::SegmentOf(index_);
+            const size_t start = Layout::SegmentStart(segment);
+            segment_end_ = start + Layout::SegmentSize(segment);
+            // Итератор end() может указывать на ещё не выделенный сегмент
+            ptr_ = segment < Layout::MAX_SEGMENTS && segments_[segment] != nullptr
+                       ? segments_[segment] + (index_ - start)
+                       : nullptr;
+        }
+
+        Table segments_ = nullptr;
+        size_t index_ = 0;
+        pointer ptr_ = nullptr;
+        size_t segment_end_ = 0;
+    };
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    iterator begin() noexcept {
+        return {segments_, 0};
+    }
+
+    iterator end() noexcept {
+        return {segments_, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {segments_, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {segments_, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    explicit SegmentedVector(size_t size, const Alloc& alloc = Alloc())
+        : SegmentedVector(alloc) {
+        Resize(size);
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+    }
+
+    // Делегирующий конструктор гарантирует вызов деструктора, если копирование элемента выбросит исключение
+    SegmentedVector(const SegmentedVector& other, const Alloc& alloc)
+        : SegmentedVector(alloc) {
+        Reserve(other.size_);
+        for (const T& item : other) {
+            EmplaceBack(item);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
+        StealSegments(other);
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                SegmentedVector tmp(rhs, rhs.alloc_);
+                FreeSegments();
+                alloc_ = tmp.alloc_;
+                StealSegments(tmp);
+            } else {
+                SegmentedVector tmp(rhs, alloc_);
+                Swap(tmp);
+            }
+        }
+        return *this;
+    }
+
+    // Сегменты rhs забираются целиком, если это позволяет аллокатор; иначе элементы перемещаются поштучно
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                                || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (CanStealSegments(rhs)) {
+                FreeSegments();
+                if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                    alloc_ = std::move(rhs.alloc_);
+                }
+                StealSegments(rhs);
+            } else {
+                Clear();
+                Reserve(rhs.size_);
+                for (T& item : rhs) {
+                    EmplaceBack(std::move(item));
+                }
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        FreeSegments();
+    }
+
+    // Аллокаторы обмениваются только при propagate_on_container_swap, иначе они обязаны быть равны
+    void Swap(SegmentedVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+        std::swap(segments_, other.segments_);
+        std::swap(segment_count_, other.segment_count_);
+        std::swap(size_, other.size_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return Layout::SegmentStart(segment_count_);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        const size_t segment = Layout::SegmentOf(index);
+        return segments_[segment][index - Layout::SegmentStart(segment)];
+    }
+
+    T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        const size_t segment = Layout::SegmentOf(index);
+        return segments_[segment][index - Layout::SegmentStart(segment)];
+    }
+
+    // Выделяет сегменты под new_capacity элементов; элементы не перемещаются
+    void Reserve(size_t new_capacity) {
+        while (Capacity() < new_capacity) {
+            AllocateSegment();
+        }
+    }
+
+    // Освобождает сегменты, в которых не осталось элементов
+    void ShrinkToFit() noexcept {
+        const size_t needed = size_ == 0 ? 0 : Layout::SegmentOf(size_ - 1) + 1;
+        while (segment_count_ > needed) {
+            --segment_count_;
+            AllocTraits::deallocate(alloc_, std::exchange(segments_[segment_count_], nullptr),
+                                    Layout::SegmentSize(segment_count_));
+        }
+    }
+
+    // Разрушает все элементы, сохраняя сегменты для повторного использования
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        while (size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Как и в Vector, на пустом векторе ничего не делает
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            std::destroy_at(&(*this)[size_ - 1]);
+            --size_;
+        }
+    }
+
+    // Элементы не перемещаются, поэтому args могут ссылаться на элементы вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t segment = Layout::SegmentOf(size_);
+        if (segment == segment_count_) {
+            AllocateSegment();
+        }
+        T* item = new (segments_[segment] + (size_ - Layout::SegmentStart(segment))) T(std::forward<Args>(args)...);
+        ++size_;
+        return *item;
+    }
+
+    // Вставка перед pos сдвигает хвост на одну позицию присваиваниями; элементы перед pos не перемещаются,
+    // и ссылки на них остаются действительными. Элемент создаётся до сдвига, поэтому args могут ссылаться
+    // на элементы вектора. Если сдвиг выбрасывает исключение, вектор остаётся согласованным (базовая гарантия)
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = pos - cbegin();
+        assert(index <= size_);
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        } else {
+            T tmp(std::forward<Args>(args)...);
+            EmplaceBack(std::move((*this)[size_ - 1]));
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+            (*this)[index] = std::move(tmp);
+        }
+        return begin() + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаление сдвигает хвост присваиваниями; ссылки на элементы перед first остаются действительными
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t index = first - cbegin();
+        const size_t count = last - first;
+        assert(index + count <= size_);
+        std::move(begin() + (index + count), end(), begin() + index);
+        for (size_t i = 0; i < count; ++i) {
+            PopBack();
+        }
+        return begin() + index;
+    }
+
+private:
+    void AllocateSegment() {
+        if (segment_count_ == Layout::MAX_SEGMENTS) {
+            throw std::length_error("SegmentedVector is too long");
+        }
+        segments_[segment_count_] = AllocTraits::allocate(alloc_, Layout::SegmentSize(segment_count_));
+        ++segment_count_;
+    }
+
+    void FreeSegments() noexcept {
+        Clear();
+        ShrinkToFit();
+    }
+
+    bool CanStealSegments(const SegmentedVector& rhs) const noexcept {
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                      || AllocTraits::is_always_equal::value) {
+            return true;
+        } else {
+            return alloc_ == rhs.alloc_;
+        }
+    }
+
+    // Забирает таблицу сегментов other; собственные сегменты должны быть уже освобождены
+    void StealSegments(SegmentedVector& other) noexcept {
+        std::copy_n(other.segments_, Layout::MAX_SEGMENTS, segments_);
+        std::fill_n(other.segments_, Layout::MAX_SEGMENTS, nullptr);
+        segment_count_ = std::exchange(other.segment_count_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    T* segments_[Layout::MAX_SEGMENTS] = {};
+    size_t segment_count_ = 0;
+    size_t size_ = 0;
+};
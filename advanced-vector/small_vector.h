@@ -0,0 +1,366 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор с оптимизацией малого буфера: первые N элементов хранятся внутри объекта,
+// и только при превышении N элементы переносятся в буфер RawMemory в куче.
+// Интерфейс повторяет Vector; рост буфера в куче подчиняется той же политике Growth
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "SmallVector must have non-empty inline storage");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Alloc& alloc) noexcept
+        : heap_(alloc) {
+    }
+
+    explicit SmallVector(size_t size, const Alloc& alloc = Alloc())
+        : heap_(alloc) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other)
+        : heap_(AllocTraits::select_on_container_copy_construction(other.heap_.GetAllocator())) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    // Буфер в куче забирается целиком, элементы из встроенного буфера переносятся поштучно
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.heap_.GetAllocator()) {
+        if (other.IsInline()) {
+            detail::RelocateN(other.Data(), other.size_, Data());
+        } else {
+            heap_ = std::move(other.heap_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    // Аллокатор rhs передаётся при propagate_on_container_copy_assignment, как в Vector::operator=
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (!AllocatorsEqual(rhs)) {
+                    // Новый аллокатор не сможет освободить текущий буфер, поэтому он не переиспользуется
+                    if (rhs.size_ > N) {
+                        RawMemory<T, Alloc> new_heap(rhs.size_, rhs.heap_.GetAllocator());
+                        std::uninitialized_copy_n(rhs.Data(), rhs.size_, new_heap.GetAddress());  // может выбросить исключение
+                        std::destroy_n(Data(), size_);
+                        heap_.ReplaceWith(std::move(new_heap));
+                        size_ = rhs.size_;
+                        return *this;
+                    }
+                    ReleaseHeap(rhs.heap_.GetAllocator());
+                }
+                heap_.GetAllocator() = rhs.heap_.GetAllocator();
+            }
+            if (rhs.size_ > Capacity()) {
+                RawMemory<T, Alloc> new_heap(rhs.size_, heap_.GetAllocator());
+                std::uninitialized_copy_n(rhs.Data(), rhs.size_, new_heap.GetAddress());  // может выбросить исключение
+                std::destroy_n(Data(), size_);
+                heap_.Swap(new_heap);
+            } else {
+                const size_t common = std::min(size_, rhs.size_);
+                std::copy_n(rhs.Data(), common, Data());
+                if (size_ > rhs.size_) {
+                    std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+                } else {
+                    std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+                }
+            }
+            size_ = rhs.size_;
+        }
+        return *this;
+    }
+
+    // Буфер rhs в куче забирается целиком, если это позволяет аллокатор; иначе элементы перемещаются поштучно.
+    // При неравных аллокаторах без propagate_on_container_move_assignment перемещение может выделить память
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && std::is_nothrow_move_assignable_v<T>
+                                                       && (AllocTraits::propagate_on_container_move_assignment::value
+                                                           || AllocTraits::is_always_equal::value)) {
+        if (this != &rhs) {
+            if (!rhs.IsInline() && CanStealHeap(rhs)) {
+                std::destroy_n(Data(), size_);
+                heap_ = std::move(rhs.heap_);
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                    // rhs во встроенном буфере: собственный буфер в куче освобождается прежним аллокатором
+                    if (!AllocatorsEqual(rhs)) {
+                        ReleaseHeap(rhs.heap_.GetAllocator());
+                    }
+                    heap_.GetAllocator() = rhs.heap_.GetAllocator();
+                }
+                MoveAssignElements(rhs);
+            }
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return Data()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Alloc> new_heap(new_capacity, heap_.GetAllocator());
+        detail::RelocateN(Data(), size_, new_heap.GetAddress());
+        heap_.Swap(new_heap);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            if (new_size > Capacity()) {
+                Reserve(NextCapacity(new_size));
+            }
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        } else {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() /* noexcept */ {
+        if (size_ > 0) {
+            std::destroy_at(Data() + size_ - 1);
+            --size_;
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            RawMemory<T, Alloc> new_heap(NextCapacity(size_ + 1), heap_.GetAllocator());
+            // Новый элемент создаётся до переноса старых, поэтому args могут ссылаться на элементы вектора
+            new (new_heap + size_) T(std::forward<Args>(args)...);
+            try {
+                detail::RelocateN(Data(), size_, new_heap.GetAddress());
+            } catch (...) {
+                std::destroy_at(new_heap + size_);
+                throw;
+            }
+            heap_.Swap(new_heap);
+        } else {
+            new (Data() + size_) T(std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Data()[size_ - 1];
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());  // Убедимся, что позиция корректна
+        const size_t index = pos - begin();  // Индекс позиции вставки
+
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        } else if (size_ == Capacity()) {
+            // --- Случай 1: требуется перевыделение памяти ---
+            RawMemory<T, Alloc> new_heap(NextCapacity(size_ + 1), heap_.GetAllocator());
+            T* new_pos = new_heap.GetAddress() + index;
+            new (new_pos) T(std::forward<Args>(args)...);
+            try {
+                detail::RelocateAroundGap(Data(), size_, index, 1, new_heap.GetAddress());
+            } catch (...) {
+                std::destroy_at(new_pos);
+                throw;
+            }
+            heap_.Swap(new_heap);
+            ++size_;
+        } else {
+            // --- Случай 2: памяти хватает, вставка "на месте" ---
+            detail::EmplaceInGap(Data(), size_, index, std::forward<Args>(args)...);
+            ++size_;
+        }
+        return begin() + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/ {
+        assert(pos >= begin() && pos < end());  // Убедимся, что позиция корректна
+
+        iterator nonconst_pos = const_cast<iterator>(pos);
+        std::move(nonconst_pos + 1, end(), nonconst_pos);  // Сдвигаем элементы влево
+        std::destroy_at(Data() + --size_);                 // Уничтожаем последний элемент
+
+        return nonconst_pos;
+    }
+
+    // Если оба вектора хранят элементы в куче, меняются только буферы;
+    // встроенные элементы приходится обменивать и переносить поштучно
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                           && std::is_nothrow_swappable_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+        } else if (IsInline() && other.IsInline()) {
+            SmallVector& larger = size_ > other.size_ ? *this : other;
+            SmallVector& smaller = size_ > other.size_ ? other : *this;
+            std::swap_ranges(smaller.Data(), smaller.Data() + smaller.size_, larger.Data());
+            detail::RelocateN(larger.Data() + smaller.size_, larger.size_ - smaller.size_,
+                              smaller.Data() + smaller.size_);
+        } else {
+            SmallVector& inline_side = IsInline() ? *this : other;
+            SmallVector& heap_side = IsInline() ? other : *this;
+            detail::RelocateN(inline_side.Data(), inline_side.size_, heap_side.InlineData());
+            inline_side.heap_.Swap(heap_side.heap_);
+        }
+        std::swap(size_, other.size_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+private:
+    T* InlineData() noexcept {
+        return reinterpret_cast<T*>(inline_buffer_);
+    }
+
+    const T* InlineData() const noexcept {
+        return reinterpret_cast<const T*>(inline_buffer_);
+    }
+
+    T* Data() noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    // Ёмкость буфера в куче, достаточная для required элементов, согласно политике роста
+    size_t NextCapacity(size_t required) const {
+        const size_t max_size = AllocTraits::max_size(heap_.GetAllocator());
+        if (required > max_size) {
+            throw std::length_error("SmallVector is too long");
+        }
+        return std::min(max_size, Growth::NextCapacity(Capacity(), required, sizeof(T)));
+    }
+
+    bool AllocatorsEqual(const SmallVector& rhs) const noexcept {
+        return heap_.GetAllocator() == rhs.heap_.GetAllocator();
+    }
+
+    // Разрушает элементы и освобождает буфер в куче текущим аллокатором, переходя на alloc и встроенный буфер
+    void ReleaseHeap(const Alloc& alloc) noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+        heap_.ReplaceWith(RawMemory<T, Alloc>(alloc));
+    }
+
+    bool CanStealHeap(const SmallVector& rhs) const noexcept {
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                      || AllocTraits::is_always_equal::value) {
+            return true;
+        } else {
+            return AllocatorsEqual(rhs);
+        }
+    }
+
+    void MoveAssignElements(SmallVector& rhs) {
+        if (rhs.size_ > Capacity()) {
+            RawMemory<T, Alloc> new_heap(rhs.size_, heap_.GetAllocator());
+            std::uninitialized_move_n(rhs.Data(), rhs.size_, new_heap.GetAddress());
+            std::destroy_n(Data(), size_);
+            heap_.Swap(new_heap);
+        } else {
+            const size_t common = std::min(size_, rhs.size_);
+            std::move(rhs.Data(), rhs.Data() + common, Data());
+            if (size_ > rhs.size_) {
+                std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+            } else {
+                std::uninitialized_move_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+            }
+        }
+        size_ = rhs.size_;
+        std::destroy_n(rhs.Data(), rhs.size_);
+        rhs.size_ = 0;
+    }
+
+    RawMemory<T, Alloc> heap_;
+    size_t size_ = 0;
+    alignas(T) unsigned char inline_buffer_[N * sizeof(T)];
+};
@@ -0,0 +1,406 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Непрерывный диапазон элементов одного столбца SoaVector для векторизуемых циклов
+template <typename T>
+class ColumnView {
+public:
+    ColumnView(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return data_[index];
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+// Вектор записей, хранящий каждое поле в отдельном столбце RawMemory (structure of arrays):
+//     SoaVector<float, float, int> particles;  // x, y, id
+//     particles.EmplaceBack(1.0f, 2.0f, 7);
+//     for (float& x : particles.Column<0>()) { ... }
+// Цикл по одному полю читает только его столбец, не загружая в кэш остальные поля записи.
+// Операции изменяют все столбцы синхронно; ёмкость растёт по политике Growth, как у Vector.
+// Перевыделение обеспечивает строгую гарантию безопасности исключений для всех столбцов сразу:
+// исходные элементы разрушаются только после успешного переноса всех столбцов. Если перемещение элементов
+// какого-либо столбца может выбросить исключение, Emplace в середине не сдвигает столбцы на месте,
+// а перестраивает их в новой памяти той же ёмкости, чтобы столбцы не рассинхронизировались. Erase всегда
+// сдвигает столбцы на месте и не выделяет памяти; если присваивание выбрасывает исключение, размер и все
+// записи остаются действительными, но значения сдвигаемых записей не определены (базовая гарантия)
+template <typename Growth, typename... Fields>
+class BasicSoaVector {
+    static_assert(sizeof...(Fields) > 0, "SoaVector must have at least one field");
+
+    using Columns = std::tuple<RawMemory<Fields>...>;
+    using Indices = std::index_sequence_for<Fields...>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    // Сдвиг элементов на месте не выбрасывает исключений ни в одном столбце, поэтому столбцы не рассинхронизируются
+    static constexpr bool NOTHROW_SHIFT = (... && (IsTriviallyRelocatableV<Fields>
+                                                   || (std::is_nothrow_move_constructible_v<Fields>
+                                                       && std::is_nothrow_move_assignable_v<Fields>)));
+
+public:
+    BasicSoaVector() = default;
+
+    explicit BasicSoaVector(size_t size) {
+        Resize(size);
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : columns_(RawMemory<Fields>(other.size_)...)
+        , capacity_(other.size_) {
+        CopyColumns(other, Indices{});
+        size_ = other.size_;
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs) {
+        if (this != &rhs) {
+            BasicSoaVector tmp(rhs);
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~BasicSoaVector() {
+        DestroyRows(0, size_, Indices{});
+    }
+
+    void Swap(BasicSoaVector& other) noexcept {
+        SwapColumns(other, Indices{});
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    // Столбец поля I как непрерывный диапазон из Size() элементов
+    template <size_t I>
+    ColumnView<Field<I>> Column() noexcept {
+        return {ColumnData<I>(), size_};
+    }
+
+    template <size_t I>
+    ColumnView<const Field<I>> Column() const noexcept {
+        return {ColumnData<I>(), size_};
+    }
+
+    // Поле I записи index
+    template <size_t I>
+    Field<I>& Get(size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return ColumnData<I>()[index];
+    }
+
+    template <size_t I>
+    const Field<I>& Get(size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return ColumnData<I>()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Reallocate(new_capacity, size_, 0);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            if (new_size > capacity_) {
+                Reserve(NextCapacity(new_size));
+            }
+            ValueConstructRows(size_, new_size - size_, Indices{});
+        } else {
+            DestroyRows(new_size, size_ - new_size, Indices{});
+        }
+        size_ = new_size;
+    }
+
+    // Разрушает все записи, сохраняя ёмкость
+    void Clear() noexcept {
+        DestroyRows(0, size_, Indices{});
+        size_ = 0;
+    }
+
+    // Как и в Vector, на пустом векторе ничего не делает
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            --size_;
+            DestroyRows(size_, 1, Indices{});
+        }
+    }
+
+    // Добавляет запись, поле I которой создаётся из аргумента I
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        Emplace(size_, std::forward<Args>(args)...);
+    }
+
+    // Вставляет запись перед записью index. При перевыделении новая запись создаётся до переноса старых,
+    // поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    void Emplace(size_t index, Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "EmplaceBack takes one argument per field");
+        assert(index <= size_);
+        auto row = std::forward_as_tuple(std::forward<Args>(args)...);
+        if (size_ == capacity_ || (!NOTHROW_SHIFT && index != size_)) {
+            const size_t new_capacity = size_ == capacity_ ? NextCapacity(size_ + 1) : capacity_;
+            Reallocate(new_capacity, index, 1, &row);
+        } else if (index == size_) {
+            ConstructRow(columns_, index, row, Indices{});
+        } else {
+            // Запись создаётся до сдвига, который уже не выбрасывает исключений
+            std::tuple<Fields...> values(std::move(row));
+            ShiftRight(index, values, Indices{});
+        }
+        ++size_;
+    }
+
+    // Удаляет запись index из всех столбцов
+    void Erase(size_t index) {
+        assert(index < size_);
+        ShiftLeft(index, Indices{});
+        --size_;
+    }
+
+private:
+    template <size_t I>
+    Field<I>* ColumnData() noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t I>
+    const Field<I>* ColumnData() const noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    size_t NextCapacity(size_t required) const {
+        if (required > std::numeric_limits<size_t>::max() / (... + sizeof(Fields))) {
+            throw std::length_error("SoaVector is too long");
+        }
+        // Политике роста передаётся размер записи целиком — столько памяти занимает одна запись во всех столбцах
+        return Growth::NextCapacity(capacity_, required, (... + sizeof(Fields)));
+    }
+
+    // Переносит записи в новые столбцы на new_capacity записей: [0, index) остаются на месте,
+    // [index, size_) сдвигаются к index + gap. Если row не нулевой, запись row создаётся в позиции index.
+    // Исходные элементы разрушаются только после успешного переноса всех столбцов
+    template <typename Row = std::tuple<>>
+    void Reallocate(size_t new_capacity, size_t index, size_t gap, Row* row = nullptr) {
+        Columns new_columns{RawMemory<Fields>(new_capacity)...};
+        if constexpr (!std::is_same_v<Row, std::tuple<>>) {
+            ConstructRow(new_columns, index, *row, Indices{});
+            try {
+                TransferColumns<0>(new_columns, index, gap);
+            } catch (...) {
+                DestroyRows(new_columns, index, 1, Indices{});
+                throw;
+            }
+        } else {
+            TransferColumns<0>(new_columns, index, gap);
+        }
+        ReleaseSources(Indices{});
+        columns_.swap(new_columns);
+        capacity_ = new_capacity;
+    }
+
+    // Создаёт перенесённые копии столбцов I и последующих, не разрушая исходные элементы.
+    // Тривиально перемещаемые столбцы копируются побайтово и после этого считаются перенесёнными
+    template <size_t I>
+    void TransferColumns(Columns& to, size_t index, size_t gap) {
+        if constexpr (I < sizeof...(Fields)) {
+            using F = Field<I>;
+            F* from = ColumnData<I>();
+            F* dest = std::get<I>(to).GetAddress();
+            const size_t tail = size_ - index;
+            if constexpr (IsTriviallyRelocatableV<F>) {
+                detail::RelocateN(from, index, dest);
+                detail::RelocateN(from + index, tail, dest + index + gap);
+                TransferColumns<I + 1>(to, index, gap);
+            } else {
+                detail::TransferN(from, index, dest);
+                try {
+                    detail::TransferN(from + index, tail, dest + index + gap);
+                } catch (...) {
+                    std::destroy_n(dest, index);
+                    throw;
+                }
+                try {
+                    TransferColumns<I + 1>(to, index, gap);
+                } catch (...) {
+                    std::destroy_n(dest, index);
+                    std::destroy_n(dest + index + gap, tail);
+                    throw;
+                }
+            }
+        }
+    }
+
+    // Разрушает исходные элементы нетривиально перемещаемых столбцов после переноса; байты тривиально
+    // перемещаемых уже принадлежат новым столбцам
+    template <size_t... I>
+    void ReleaseSources(std::index_sequence<I...>) noexcept {
+        (..., [&] {
+            if constexpr (!IsTriviallyRelocatableV<Field<I>>) {
+                std::destroy_n(ColumnData<I>(), size_);
+            }
+        }());
+    }
+
+    // Создаёт поля записи index из row; при исключении уже созданные поля этой записи разрушаются
+    template <typename Row, size_t... I>
+    static void ConstructRow(Columns& columns, size_t index, Row& row, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            (..., (new (std::get<I>(columns).GetAddress() + index)
+                       Field<I>(std::get<I>(std::move(row))),
+                   ++constructed));
+        } catch (...) {
+            (..., (I < constructed ? std::destroy_at(std::get<I>(columns).GetAddress() + index) : void()));
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void ValueConstructRows(size_t first, size_t count, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            (..., (std::uninitialized_value_construct_n(ColumnData<I>() + first, count), ++constructed));
+        } catch (...) {
+            (..., (I < constructed ? std::destroy_n(ColumnData<I>() + first, count) : nullptr));
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void CopyColumns(const BasicSoaVector& other, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            (..., (std::uninitialized_copy_n(other.template ColumnData<I>(), other.size_, ColumnData<I>()),
+                   ++constructed));
+        } catch (...) {
+            (..., (I < constructed ? std::destroy_n(ColumnData<I>(), other.size_) : nullptr));
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void DestroyRows(size_t first, size_t count, std::index_sequence<I...>) noexcept {
+        (..., std::destroy_n(ColumnData<I>() + first, count));
+    }
+
+    template <size_t... I>
+    static void DestroyRows(Columns& columns, size_t first, size_t count, std::index_sequence<I...>) noexcept {
+        (..., std::destroy_n(std::get<I>(columns).GetAddress() + first, count));
+    }
+
+    // Сдвигает записи [index, size_) на одну позицию вправо и переносит values в позицию index
+    template <size_t... I>
+    void ShiftRight(size_t index, std::tuple<Fields...>& values, std::index_sequence<I...>) noexcept {
+        (..., [&] {
+            using F = Field<I>;
+            F* data = ColumnData<I>();
+            if constexpr (IsTriviallyRelocatableV<F>) {
+                std::memmove(static_cast<void*>(data + index + 1), static_cast<const void*>(data + index),
+                             (size_ - index) * sizeof(F));
+                new (data + index) F(std::move(std::get<I>(values)));
+            } else {
+                new (data + size_) F(std::move(data[size_ - 1]));
+                std::move_backward(data + index, data + size_ - 1, data + size_);
+                data[index] = std::move(std::get<I>(values));
+            }
+        }());
+    }
+
+    // Удаляет запись index, сдвигая последующие на одну позицию влево. Сначала сдвигаются присваиванием
+    // столбцы, где это может выбросить исключение, — при исключении все столбцы ещё содержат size_ элементов;
+    // затем без исключений сдвигаются тривиально перемещаемые столбцы и разрушаются освободившиеся элементы
+    template <size_t... I>
+    void ShiftLeft(size_t index, std::index_sequence<I...>) {
+        (..., [&] {
+            using F = Field<I>;
+            if constexpr (!IsTriviallyRelocatableV<F>) {
+                F* data = ColumnData<I>();
+                std::move(data + index + 1, data + size_, data + index);
+            }
+        }());
+        (..., [&]() noexcept {
+            using F = Field<I>;
+            F* data = ColumnData<I>();
+            if constexpr (IsTriviallyRelocatableV<F>) {
+                std::destroy_at(data + index);
+                std::memmove(static_cast<void*>(data + index), static_cast<const void*>(data + index + 1),
+                             (size_ - index - 1) * sizeof(F));
+            } else {
+                std::destroy_at(data + size_ - 1);
+            }
+        }());
+    }
+
+    template <size_t... I>
+    void SwapColumns(BasicSoaVector& other, std::index_sequence<I...>) noexcept {
+        (..., std::get<I>(columns_).Swap(std::get<I>(other.columns_)));
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+template <typename... Fields>
+using SoaVector = BasicSoaVector<DoublingGrowth, Fields...>;
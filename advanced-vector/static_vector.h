@@ -0,0 +1,362 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// В C++20 методы StaticVector тривиальных типов можно вызывать при вычислениях на этапе компиляции
+#if __cplusplus >= 202002L
+#define ADVANCED_VECTOR_CONSTEXPR20 constexpr
+#else
+#define ADVANCED_VECTOR_CONSTEXPR20
+#endif
+
+namespace detail {
+
+ADVANCED_VECTOR_CONSTEXPR20 inline bool IsConstantEvaluated() noexcept {
+#if __cplusplus >= 202002L
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Создаёт объект в памяти p; в C++20 — через std::construct_at, допустимый в constexpr
+template <typename T, typename... Args>
+ADVANCED_VECTOR_CONSTEXPR20 T* ConstructAt(T* p, Args&&... args) {
+#if __cplusplus >= 202002L
+    return std::construct_at(p, std::forward<Args>(args)...);
+#else
+    return new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Встроенное хранилище StaticVector. Для тривиальных типов это массив T: при вычислении на этапе компиляции
+// он заполняется значениями по умолчанию, во время выполнения остаётся неинициализированным
+template <typename T, size_t N, bool = std::is_trivial_v<T>>
+struct StaticStorage {
+    ADVANCED_VECTOR_CONSTEXPR20 StaticStorage() noexcept {
+        if (IsConstantEvaluated()) {
+            for (T& item : items) {
+                item = T();
+            }
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 T* Data() noexcept {
+        return items;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const T* Data() const noexcept {
+        return items;
+    }
+
+    T items[N];
+};
+
+// Для остальных типов — сырая память; такие векторы работают только во время выполнения
+template <typename T, size_t N>
+struct StaticStorage<T, N, false> {
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(bytes));
+    }
+
+    const T* Data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(bytes));
+    }
+
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+};
+
+}  // namespace detail
+
+// Вектор ёмкостью не более N элементов, хранящихся внутри объекта; куча не используется никогда.
+// Интерфейс повторяет Vector, а попытка превысить ёмкость выбрасывает std::length_error
+// (TryEmplaceBack вместо этого возвращает nullptr). Для тривиальных T в C++20 все методы constexpr,
+// поэтому таблицы можно строить на этапе компиляции
+template <typename T, size_t N>
+class StaticVector {
+    static_assert(N > 0, "StaticVector must have non-empty storage");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector() noexcept = default;
+
+    ADVANCED_VECTOR_CONSTEXPR20 explicit StaticVector(size_t size) {
+        Resize(size);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector(std::initializer_list<T> values) {
+        CheckCapacity(values.size());
+        for (const T& value : values) {
+            UncheckedEmplaceBack(value);
+        }
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector(const StaticVector& other) {
+        for (const T& item : other) {
+            UncheckedEmplaceBack(item);
+        }
+    }
+
+    // Элементы перемещаются поштучно; other сохраняет свои (перемещённые) элементы
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        for (T& item : other) {
+            UncheckedEmplaceBack(std::move(item));
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.begin(), rhs.size_);
+        }
+        return *this;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 StaticVector& operator=(StaticVector&& rhs) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+        if (this != &rhs) {
+            Assign(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+        return *this;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 ~StaticVector() {
+        Clear();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator begin() noexcept {
+        return storage_.Data();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator end() noexcept {
+        return storage_.Data() + size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const_iterator begin() const noexcept {
+        return storage_.Data();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const_iterator end() const noexcept {
+        return storage_.Data() + size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const_iterator cend() const noexcept {
+        return end();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 size_t Size() const noexcept {
+        return size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 T* Data() noexcept {
+        return storage_.Data();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const T* Data() const noexcept {
+        return storage_.Data();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const T& operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return storage_.Data()[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return storage_.Data()[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 const T& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("StaticVector index is out of range");
+        }
+        return storage_.Data()[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 T& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("StaticVector index is out of range");
+        }
+        return storage_.Data()[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        while (size_ < new_size) {
+            UncheckedEmplaceBack();
+        }
+        while (size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Как и в Vector, на пустом векторе ничего не делает
+    ADVANCED_VECTOR_CONSTEXPR20 void PopBack() noexcept {
+        if (size_ > 0) {
+            --size_;
+            std::destroy_at(storage_.Data() + size_);
+        }
+    }
+
+    // Элементы никогда не перемещаются при добавлении, поэтому args могут ссылаться на элементы вектора
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR20 T& EmplaceBack(Args&&... args) {
+        CheckCapacity(size_ + 1);
+        return UncheckedEmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Добавляет элемент, если есть место; иначе возвращает nullptr
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR20 T* TryEmplaceBack(Args&&... args) {
+        return size_ < N ? &UncheckedEmplaceBack(std::forward<Args>(args)...) : nullptr;
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR20 iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = pos - begin();
+        CheckCapacity(size_ + 1);
+        if (index == size_) {
+            UncheckedEmplaceBack(std::forward<Args>(args)...);
+        } else if (detail::IsConstantEvaluated()) {
+            // Вычисление на этапе компиляции не допускает memmove и placement new, поэтому хвост
+            // сдвигается поэлементно, а новый элемент собирается заранее
+            T value(std::forward<Args>(args)...);
+            T* data = storage_.Data();
+            detail::ConstructAt(data + size_, std::move(data[size_ - 1]));
+            std::move_backward(data + index, data + size_ - 1, data + size_);
+            data[index] = std::move(value);
+            ++size_;
+        } else {
+            detail::EmplaceInGap(storage_.Data(), size_, index, std::forward<Args>(args)...);
+            ++size_;
+        }
+        return begin() + index;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator Erase(const_iterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        const size_t index = first - begin();
+        const size_t count = last - first;
+        T* data = storage_.Data();
+        std::move(data + index + count, data + size_, data + index);
+        for (size_t i = 0; i < count; ++i) {
+            PopBack();
+        }
+        return data + index;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR20 void Swap(StaticVector& other) noexcept(std::is_nothrow_swappable_v<T>
+                                                                        && std::is_nothrow_move_constructible_v<T>) {
+        StaticVector& longer = size_ >= other.size_ ? *this : other;
+        StaticVector& shorter = size_ >= other.size_ ? other : *this;
+        const size_t common = shorter.size_;
+        for (size_t i = 0; i < common; ++i) {
+            using std::swap;
+            swap(longer[i], shorter[i]);
+        }
+        while (shorter.size_ < longer.size_) {
+            shorter.UncheckedEmplaceBack(std::move(longer[shorter.size_]));
+        }
+        while (longer.size_ > common) {
+            longer.PopBack();
+        }
+    }
+
+    friend ADVANCED_VECTOR_CONSTEXPR20 bool operator==(const StaticVector& lhs, const StaticVector& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend ADVANCED_VECTOR_CONSTEXPR20 bool operator!=(const StaticVector& lhs, const StaticVector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    ADVANCED_VECTOR_CONSTEXPR20 static void CheckCapacity(size_t required) {
+        if (required > N) {
+            throw std::length_error("StaticVector capacity is exceeded");
+        }
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR20 T& UncheckedEmplaceBack(Args&&... args) {
+        T* item = detail::ConstructAt(storage_.Data() + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *item;
+    }
+
+    // Присваивает count элементов, начиная с first: общая часть присваивается, остальное создаётся или разрушается
+    template <typename It>
+    ADVANCED_VECTOR_CONSTEXPR20 void Assign(It first, size_t count) {
+        const size_t common = std::min(size_, count);
+        T* data = storage_.Data();
+        for (size_t i = 0; i < common; ++i, ++first) {
+            data[i] = *first;
+        }
+        for (size_t i = common; i < count; ++i, ++first) {
+            UncheckedEmplaceBack(*first);
+        }
+        while (size_ > count) {
+            PopBack();
+        }
+    }
+
+    detail::StaticStorage<T, N> storage_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,215 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+// Инструменты для тестов и бенчмарков контейнеров: считающий аллокатор, тип элемента со счётчиками
+// операций, измерение стоимости отдельной операции (Measure) и внедрение отказов в каждую точку,
+// где операция может выбросить исключение (InjectFailures). Счётчики общие для всей программы и не
+// синхронизированы, поэтому инструменты предназначены для однопоточных проверок
+
+// Число выделений памяти и операций над элементами. Глобальный экземпляр harness_counters накапливает
+// их с начала программы, Measure возвращает разность, набранную одной операцией
+struct OperationCost {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t allocated_bytes = 0;
+    size_t constructions = 0;
+    size_t copies = 0;
+    size_t moves = 0;
+    size_t copy_assignments = 0;
+    size_t move_assignments = 0;
+    size_t destructions = 0;
+
+    // Созданные и ещё не разрушенные элементы
+    size_t LiveObjects() const noexcept {
+        return constructions + copies + moves - destructions;
+    }
+
+    size_t LiveAllocations() const noexcept {
+        return allocations - deallocations;
+    }
+
+    friend OperationCost operator-(const OperationCost& lhs, const OperationCost& rhs) noexcept {
+        OperationCost cost;
+        cost.allocations = lhs.allocations - rhs.allocations;
+        cost.deallocations = lhs.deallocations - rhs.deallocations;
+        cost.allocated_bytes = lhs.allocated_bytes - rhs.allocated_bytes;
+        cost.constructions = lhs.constructions - rhs.constructions;
+        cost.copies = lhs.copies - rhs.copies;
+        cost.moves = lhs.moves - rhs.moves;
+        cost.copy_assignments = lhs.copy_assignments - rhs.copy_assignments;
+        cost.move_assignments = lhs.move_assignments - rhs.move_assignments;
+        cost.destructions = lhs.destructions - rhs.destructions;
+        return cost;
+    }
+};
+
+inline OperationCost harness_counters;
+
+// Исключение, которое InjectFailures выбрасывает в выбранной точке отказа
+struct InjectedFailure : std::runtime_error {
+    InjectedFailure()
+        : std::runtime_error("Injected failure") {
+    }
+};
+
+namespace detail {
+
+// Номер следующей точки отказа, в которой будет выброшено InjectedFailure; 0 — отказы отключены
+inline size_t failure_countdown = 0;
+
+inline void FailurePoint() {
+    if (failure_countdown > 0 && --failure_countdown == 0) {
+        throw InjectedFailure();
+    }
+}
+
+// Сообщает об утечке после прохода InjectFailures и аварийно завершает программу. В отличие от assert,
+// проверка выполняется и в сборках с NDEBUG
+inline void CheckNoLeak(const char* what, size_t expected, size_t actual, size_t point) {
+    if (expected != actual) {
+        std::fprintf(stderr, "InjectFailures: %s leaked at failure point %zu: expected %zu, got %zu\n", what, point,
+                     expected, actual);
+        std::abort();
+    }
+}
+
+}  // namespace detail
+
+// Аллокатор, подсчитывающий выделения памяти в harness_counters. Каждое выделение — точка отказа
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        detail::FailurePoint();
+        T* ptr = std::allocator<T>().allocate(n);
+        ++harness_counters.allocations;
+        harness_counters.allocated_bytes += n * sizeof(T);
+        return ptr;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ++harness_counters.deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+// Элемент, подсчитывающий свои создания, копирования, перемещения, присваивания и разрушения.
+// Каждое создание и присваивание, которое может выбросить исключение, — точка отказа. При NothrowMove = false
+// перемещение тоже может выбросить исключение, и контейнеры обязаны переносить такие элементы копированием
+template <bool NothrowMove>
+struct BasicTrackedObj {
+    BasicTrackedObj() {
+        detail::FailurePoint();
+        ++harness_counters.constructions;
+    }
+
+    explicit BasicTrackedObj(int value)
+        : value(value) {
+        detail::FailurePoint();
+        ++harness_counters.constructions;
+    }
+
+    BasicTrackedObj(const BasicTrackedObj& other)
+        : value(other.value) {
+        detail::FailurePoint();
+        ++harness_counters.copies;
+    }
+
+    BasicTrackedObj(BasicTrackedObj&& other) noexcept(NothrowMove)
+        : value(other.value) {
+        if constexpr (!NothrowMove) {
+            detail::FailurePoint();
+        }
+        ++harness_counters.moves;
+    }
+
+    BasicTrackedObj& operator=(const BasicTrackedObj& rhs) {
+        detail::FailurePoint();
+        value = rhs.value;
+        ++harness_counters.copy_assignments;
+        return *this;
+    }
+
+    BasicTrackedObj& operator=(BasicTrackedObj&& rhs) noexcept(NothrowMove) {
+        if constexpr (!NothrowMove) {
+            detail::FailurePoint();
+        }
+        value = rhs.value;
+        ++harness_counters.move_assignments;
+        return *this;
+    }
+
+    ~BasicTrackedObj() {
+        ++harness_counters.destructions;
+    }
+
+    friend bool operator==(const BasicTrackedObj& lhs, const BasicTrackedObj& rhs) noexcept {
+        return lhs.value == rhs.value;
+    }
+
+    friend bool operator!=(const BasicTrackedObj& lhs, const BasicTrackedObj& rhs) noexcept {
+        return lhs.value != rhs.value;
+    }
+
+    int value = 0;
+};
+
+using TrackedObj = BasicTrackedObj<true>;
+using ThrowingMoveTrackedObj = BasicTrackedObj<false>;
+
+// Выполняет op и возвращает выделения памяти и операции над элементами, которые он выполнил
+template <typename Op>
+OperationCost Measure(Op&& op) {
+    const OperationCost before = harness_counters;
+    op();
+    return harness_counters - before;
+}
+
+// Проверяет op во всех его точках отказа. На каждом проходе setup() без отказов готовит новое состояние,
+// затем op(state) выполняется с отказом в очередной точке, а check(state, failed) проверяет состояние
+// после него. Проходы повторяются, пока op не завершится без отказа; после каждого прохода все элементы
+// и память должны быть освобождены. Возвращает число точек отказа
+template <typename Setup, typename Op, typename Check>
+size_t InjectFailures(Setup&& setup, Op&& op, Check&& check) {
+    const OperationCost baseline = harness_counters;
+    for (size_t point = 1;; ++point) {
+        bool failed = false;
+        {
+            auto state = setup();
+            detail::failure_countdown = point;
+            try {
+                op(state);
+            } catch (const InjectedFailure&) {
+                failed = true;
+            }
+            detail::failure_countdown = 0;
+            check(state, failed);
+        }
+        detail::CheckNoLeak("objects", baseline.LiveObjects(), harness_counters.LiveObjects(), point);
+        detail::CheckNoLeak("allocations", baseline.LiveAllocations(), harness_counters.LiveAllocations(), point);
+        if (!failed) {
+            return point - 1;
+        }
+    }
+}
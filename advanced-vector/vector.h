@@ -1,69 +1,419 @@
 /* Разместите здесь код класса Vector*/
 #pragma once
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <new>
+#include <stdexcept>
 #include <utility>
 #include <memory>
 #include <type_traits>
 
 
-//Шаблонный класс RawMemory будет отвечать за хранение буфера, который вмещает заданное количество элементов, и предоставлять доступ к элементам по индексу
+// Тип тривиально перемещаем (trivially relocatable), если перенос объекта в новую память можно выполнить
+// побайтовым копированием, не вызывая конструктор перемещения и деструктор исходного объекта.
+// По умолчанию это тривиально копируемые типы; для своих типов (дескрипторы, умные указатели)
+// достаточно специализировать шаблон
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Аллокатор умеет расширять буфер на месте, если предоставляет метод
+// T* reallocate(T* p, size_t old_n, size_t new_n) с семантикой realloc: содержимое переносится побайтово,
+// при ошибке выбрасывается исключение, а старый буфер остаётся действительным.
+// Как и allocate_at_least, reallocate может вернуть AllocationResult<T> с реальной ёмкостью нового буфера
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>> : std::true_type {};
+
+template <typename Alloc>
+inline constexpr bool HasReallocateV = HasReallocate<Alloc>::value;
+
+// Результат allocate_at_least: аллокатор может выделить больше запрошенного (до своего класса размера),
+// тогда вся выделенная память становится ёмкостью буфера
+template <typename T>
+struct AllocationResult {
+    T* ptr;
+    size_t count;
+};
+
+// Аллокатор сообщает реальный размер выделенного блока, если предоставляет
+// allocate_at_least(n) в духе C++23 (результат с полями ptr и count)
+template <typename Alloc, typename = void>
+struct HasAllocateAtLeast : std::false_type {};
+
+template <typename Alloc>
+struct HasAllocateAtLeast<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(size_t{}))>>
+    : std::true_type {};
+
+template <typename Alloc>
+inline constexpr bool HasAllocateAtLeastV = HasAllocateAtLeast<Alloc>::value;
+
+// Политика выполнения поэлементных операций над большими диапазонами (например, ParallelPolicy из vector_parallel.h).
+// Политика предоставляет метод ForEachChunk(n, op, undo): делит [0, n) на части [first, last) и вызывает
+// op(first, last) для каждой, возможно в разных потоках. Если op выбрасывает исключение, он обязан оставить
+// свою часть нетронутой; тогда для всех успешно обработанных частей вызывается undo(first, last),
+// и исключение передаётся вызывающему. Типы политик регистрируются специализацией IsExecutionPolicy
+template <typename Policy>
+struct IsExecutionPolicy : std::false_type {};
+
+template <typename Policy>
+inline constexpr bool IsExecutionPolicyV = IsExecutionPolicy<Policy>::value;
+
+// Режимы проверки индексов в operator[] (макрос ADVANCED_VECTOR_BOUNDS_CHECK, задаётся до подключения заголовков):
+// ADVANCED_VECTOR_BOUNDS_ASSERT (по умолчанию) — assert, то есть только в сборках без NDEBUG;
+// ADVANCED_VECTOR_BOUNDS_TRAP — аварийный останов при выходе за границы в любой сборке (для staging);
+// ADVANCED_VECTOR_BOUNDS_OFF — без проверок в любой сборке.
+// Независимо от режима At() выбрасывает std::out_of_range, а Data() и UncheckedAt() не проверяют ничего
+#define ADVANCED_VECTOR_BOUNDS_OFF 0
+#define ADVANCED_VECTOR_BOUNDS_ASSERT 1
+#define ADVANCED_VECTOR_BOUNDS_TRAP 2
+
+#ifndef ADVANCED_VECTOR_BOUNDS_CHECK
+#define ADVANCED_VECTOR_BOUNDS_CHECK ADVANCED_VECTOR_BOUNDS_ASSERT
+#endif
+
+#if ADVANCED_VECTOR_BOUNDS_CHECK == ADVANCED_VECTOR_BOUNDS_TRAP
+#define ADVANCED_VECTOR_CHECK_BOUNDS(condition) ((condition) ? void() : detail::BoundsTrap())
+#elif ADVANCED_VECTOR_BOUNDS_CHECK == ADVANCED_VECTOR_BOUNDS_ASSERT
+#define ADVANCED_VECTOR_CHECK_BOUNDS(condition) assert(condition)
+#else
+#define ADVANCED_VECTOR_CHECK_BOUNDS(condition) ((void)0)
+#endif
+
+namespace detail {
+
+[[noreturn]] inline void BoundsTrap() noexcept {
+#if defined(__GNUC__)
+    __builtin_trap();
+#else
+    std::abort();
+#endif
+}
+
+template <typename It>
+using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+// Ограничивает шаблоны, принимающие диапазон [first, last), входными итераторами,
+// чтобы вызовы вида Insert(pos, 3, 5) выбирали перегрузку с количеством
+template <typename It>
+using RequireInputIterator = std::enable_if_t<
+    std::is_convertible_v<IteratorCategory<It>, std::input_iterator_tag>>;
+
+template <typename Policy>
+using RequireExecutionPolicy = std::enable_if_t<IsExecutionPolicyV<Policy>>;
+
+template <typename It>
+inline constexpr bool IsForwardIteratorV = std::is_convertible_v<IteratorCategory<It>, std::forward_iterator_tag>;
+
+// Создаёт в неинициализированной памяти to копии n объектов из from: перемещением, если оно не бросает
+// исключений или копирование невозможно, иначе копированием. Исходные объекты не разрушаются.
+// При исключении уже созданные объекты разрушаются
+template <typename T>
+void TransferN(T* from, size_t n, T* to) {
+    // проверка на перемещяемость или на возможность копирования
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(from, n, to);
+    } else if constexpr (std::is_copy_constructible_v<T>) {
+        std::uninitialized_copy_n(from, n, to);
+    } else if constexpr (std::is_move_constructible_v<T>) {
+        // Перемещение с возможными исключениями — тоже допустимо
+        std::uninitialized_move_n(from, n, to);
+    } else {
+        static_assert(std::is_move_constructible_v<T> || std::is_copy_constructible_v<T>,
+                    "Type T must be either move or copy constructible");
+    }
+}
+
+// Переносит n объектов из from в неинициализированную память to и разрушает исходные объекты.
+// Тривиально перемещаемые типы переносятся одним memcpy без вызова деструкторов.
+// Если копирование выбрасывает исключение, исходные объекты остаются нетронутыми
 template <typename T>
+void RelocateN(T* from, size_t n, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+        }
+    } else {
+        TransferN(from, n, to);
+        std::destroy_n(from, n);
+    }
+}
+
+// Переносит n объектов из from в to, оставляя в to пропуск шириной gap элементов перед позицией index:
+// [0, index) -> [0, index), [index, n) -> [index + gap, n + gap).
+// Исходные объекты разрушаются только после успешного переноса всех элементов
+template <typename T>
+void RelocateAroundGap(T* from, size_t n, size_t index, size_t gap, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        RelocateN(from, index, to);
+        RelocateN(from + index, n - index, to + index + gap);
+    } else {
+        TransferN(from, index, to);
+        try {
+            TransferN(from + index, n - index, to + index + gap);
+        } catch (...) {
+            std::destroy_n(to, index);
+            throw;
+        }
+        std::destroy_n(from, n);
+    }
+}
+
+// Адрес одного из args лежит в памяти [first, last), то есть аргумент является элементом или его частью
+template <typename T, typename... Args>
+bool AnyArgWithin(const T* first, const T* last, const Args&... args) noexcept {
+    const void* lo = first;
+    const void* hi = last;
+    return (... || (std::less_equal<const void*>()(lo, std::addressof(args))
+                    && std::less<const void*>()(std::addressof(args), hi)));
+}
+
+// Создаёт элемент из args перед data[index] в буфере из size элементов, где есть место ещё для одного
+// (index < size). Хвост [index, size) сдвигается на одну позицию один раз, а новый элемент создаётся
+// прямо в освободившейся ячейке. Если args ссылаются на сдвигаемые элементы (или конструктор может
+// выбросить исключение, а хвост нельзя вернуть на место), элемент сначала создаётся во временном объекте.
+// Для тривиально перемещаемых и nothrow-перемещаемых типов при исключении буфер остаётся прежним,
+// для остальных действует базовая гарантия
+template <typename T, typename... Args>
+T* EmplaceInGap(T* data, size_t size, size_t index, Args&&... args) {
+    assert(index < size);
+    T* pos = data + index;
+    const bool aliased = AnyArgWithin(pos, data + size, args...);
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        const size_t tail_bytes = (size - index) * sizeof(T);
+        if (aliased) {
+            alignas(T) unsigned char slot[sizeof(T)];
+            new (slot) T(std::forward<Args>(args)...);
+            std::memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), tail_bytes);
+            std::memcpy(static_cast<void*>(pos), static_cast<const void*>(slot), sizeof(T));
+        } else {
+            std::memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), tail_bytes);
+            try {
+                new (pos) T(std::forward<Args>(args)...);
+            } catch (...) {
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + 1), tail_bytes);
+                throw;
+            }
+        }
+    } else if constexpr (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+        auto shift_tail = [&]() noexcept {
+            new (data + size) T(std::move(data[size - 1]));
+            std::move_backward(pos, data + size - 1, data + size);
+            std::destroy_at(pos);
+        };
+        if (std::is_nothrow_constructible_v<T, Args&&...> && !aliased) {
+            shift_tail();
+            new (pos) T(std::forward<Args>(args)...);
+        } else {
+            T tmp(std::forward<Args>(args)...);
+            shift_tail();
+            new (pos) T(std::move(tmp));
+        }
+    } else {
+        T tmp(std::forward<Args>(args)...);
+        new (data + size) T(std::move_if_noexcept(data[size - 1]));
+        try {
+            std::move_backward(pos, data + size - 1, data + size);
+            *pos = std::move(tmp);
+        } catch (...) {
+            std::destroy_at(data + size);
+            throw;
+        }
+    }
+    return pos;
+}
+
+// Разрушает n объектов частями по политике policy
+template <typename Policy, typename T>
+void DestroyN(const Policy& policy, T* first, size_t n) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        policy.ForEachChunk(
+            n, [first](size_t begin, size_t end) { std::destroy(first + begin, first + end); },
+            [](size_t, size_t) {});
+    }
+}
+
+// То же, что RelocateN, но части диапазона переносятся по политике policy.
+// Если перенос какой-либо части выбрасывает исключение, исходные объекты остаются нетронутыми
+template <typename Policy, typename T>
+void RelocateN(const Policy& policy, T* from, size_t n, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        policy.ForEachChunk(
+            n, [from, to](size_t begin, size_t end) { RelocateN(from + begin, end - begin, to + begin); },
+            [](size_t, size_t) {});
+    } else {
+        policy.ForEachChunk(
+            n, [from, to](size_t begin, size_t end) { TransferN(from + begin, end - begin, to + begin); },
+            [to](size_t begin, size_t end) { std::destroy(to + begin, to + end); });
+        DestroyN(policy, from, n);
+    }
+}
+
+}  // namespace detail
+
+// Политика статистики получает уведомления о работе с памятью:
+// OnAllocate(capacity, bytes) — RawMemory получил буфер на capacity элементов;
+// OnReallocate(relocated) — Vector заменил или расширил непустой буфер, перенеся поэлементно relocated элементов;
+// при расширении через Alloc::reallocate (realloc, mremap) элементы не переносятся и relocated равен 0.
+// NoStats ничего не считает, и после инлайнинга от вызовов не остаётся кода.
+// Считающая политика с глобальным реестром — CountingStats из vector_stats.h
+struct NoStats {
+    static void OnAllocate(size_t /*capacity*/, size_t /*bytes*/) noexcept {
+    }
+
+    static void OnReallocate(size_t /*relocated*/) noexcept {
+    }
+};
+
+//Шаблонный класс RawMemory будет отвечать за хранение буфера, который вмещает заданное количество элементов, и предоставлять доступ к элементам по индексу
+// Память выделяется через аллокатор Alloc (совместимый с std::allocator_traits), который хранится вместе с буфером
+template <typename T, typename Alloc = std::allocator<T>, typename Stats = NoStats>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Alloc::value_type must be the same as T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T*>,
+                  "RawMemory supports only allocators with raw pointers");
+
 public:
+    using allocator_type = Alloc;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
+    explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    // Ёмкость может оказаться больше запрошенной, если аллокатор поддерживает allocate_at_least
+    explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc) {
+        auto [buffer, count] = Allocate(capacity);
+        buffer_ = buffer;
+        capacity_ = count;
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept {
+    // Аллокатор перемещается вместе с буфером, как в конструкторе перемещения стандартных контейнеров
+    RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
         buffer_ = other.buffer_;
         capacity_ = other.capacity_;
         other.buffer_ = nullptr;
         other.capacity_ = 0;
     }
 
+    // Аллокатор передаётся только при propagate_on_container_move_assignment,
+    // иначе аллокаторы обязаны быть равны (неравные обрабатывает Vector поэлементно)
     RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            Swap(rhs);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                ReplaceWith(std::move(rhs));
+            } else {
+                assert(alloc_ == rhs.alloc_);
+                Deallocate(buffer_, capacity_);
+                buffer_ = std::exchange(rhs.buffer_, nullptr);
+                capacity_ = std::exchange(rhs.capacity_, 0);
+            }
         }
         return *this;
     }
 
     ~RawMemory() {
-        Deallocate(buffer_);
+        Deallocate(buffer_, capacity_);
     }
 
     T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
-        assert(offset <= capacity_);
+        ADVANCED_VECTOR_CHECK_BOUNDS(offset <= capacity_);
         return buffer_ + offset;
     }
 
     const T* operator+(size_t offset) const noexcept {
-        return const_cast<RawMemory&>(*this) + offset;
+        ADVANCED_VECTOR_CHECK_BOUNDS(offset <= capacity_);
+        return buffer_ + offset;
     }
 
     const T& operator[](size_t index) const noexcept {
-        return const_cast<RawMemory&>(*this)[index];
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < capacity_);
+        return buffer_[index];
     }
 
     T& operator[](size_t index) noexcept {
-        assert(index < capacity_);
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < capacity_);
         return buffer_[index];
     }
 
+    // Аллокаторы обмениваются только при propagate_on_container_swap, иначе они обязаны быть равны
     void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
+    // Изменяет ёмкость буфера средствами аллокатора (realloc/mremap) без поэлементного переноса.
+    // Допустимо только для тривиально перемещаемых T; при исключении буфер остаётся прежним
+    void Reallocate(size_t new_capacity) {
+        static_assert(HasReallocateV<Alloc>, "Alloc must provide reallocate()");
+        if (buffer_ == nullptr) {
+            auto [buffer, count] = Allocate(new_capacity);
+            buffer_ = buffer;
+            capacity_ = count;
+        } else {
+            if constexpr (std::is_same_v<decltype(alloc_.reallocate(buffer_, capacity_, new_capacity)),
+                                         AllocationResult<T>>) {
+                auto [buffer, count] = alloc_.reallocate(buffer_, capacity_, new_capacity);
+                buffer_ = buffer;
+                capacity_ = count;
+            } else {
+                buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+                capacity_ = new_capacity;
+            }
+            Stats::OnAllocate(capacity_, capacity_ * sizeof(T));
+        }
+    }
+
+    // Освобождает текущий буфер и забирает буфер other вместе с его аллокатором независимо от propagate_on_*
+    void ReplaceWith(RawMemory&& other) noexcept {
+        Deallocate(buffer_, capacity_);
+        alloc_ = std::move(other.alloc_);
+        buffer_ = std::exchange(other.buffer_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+    }
+
+    // Освобождает текущий буфер и становится владельцем buffer — буфера на capacity элементов,
+    // выделенного аллокатором, равным текущему
+    void Adopt(T* buffer, size_t capacity) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = buffer;
+        capacity_ = capacity;
+    }
+
+    // Отказывается от владения буфером и возвращает его; освободить буфер должен вызывающий
+    T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
     const T* GetAddress() const noexcept {
         return buffer_;
     }
@@ -76,24 +426,115 @@ public:
         return capacity_;
     }
 
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    Alloc& GetAllocator() noexcept {
+        return alloc_;
+    }
+
 private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    // Выделяет сырую память не менее чем под n элементов и возвращает указатель на неё и реальную ёмкость
+    AllocationResult<T> Allocate(size_t n) {
+        if (n == 0) {
+            return {nullptr, 0};
+        }
+        AllocationResult<T> result{nullptr, n};
+        if constexpr (HasAllocateAtLeastV<Alloc>) {
+            auto [ptr, count] = alloc_.allocate_at_least(n);
+            result = {ptr, count};
+        } else {
+            result.ptr = AllocTraits::allocate(alloc_, n);
+        }
+        Stats::OnAllocate(result.count, result.count * sizeof(T));
+        return result;
     }
 
     // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+        }
     }
 
+    [[no_unique_address]] Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
+// Политики роста определяют новую ёмкость при нехватке места в EmplaceBack, Emplace и Resize.
+// NextCapacity(capacity, required, elem_size) возвращает ёмкость не меньше required.
+// Reserve политику не использует и выделяет ровно запрошенное
+
+// Удвоение ёмкости (1 -> 2 -> 4 -> ...)
+struct DoublingGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*elem_size*/) noexcept {
+        const size_t doubled = capacity > std::numeric_limits<size_t>::max() / 2
+            ? std::numeric_limits<size_t>::max() : capacity * 2;
+        return std::max(required, doubled);
+    }
+};
+
+// Рост в 1.5 раза: освобождённые ранее блоки суммарно успевают вместить новый, и аллокатор может их переиспользовать
+struct OneAndHalfGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*elem_size*/) noexcept {
+        const size_t grown = capacity > std::numeric_limits<size_t>::max() / 3 * 2
+            ? std::numeric_limits<size_t>::max() : capacity + capacity / 2;
+        return std::max(required, grown);
+    }
+};
+
+// Минимальная ёмкость первого выделения, чтобы избежать цепочки перевыделений 1 -> 2 -> 4 -> 8 у маленьких векторов
+template <size_t MinCapacity, typename Base = DoublingGrowth>
+struct MinCapacityGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) noexcept {
+        return std::max(MinCapacity, Base::NextCapacity(capacity, required, elem_size));
+    }
+};
+
+// Округляет буферы размером больше страницы до целого числа страниц, чтобы хвост последней страницы не пропадал
+template <typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct PageRoundedGrowth {
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) noexcept {
+        const size_t n = Base::NextCapacity(capacity, required, elem_size);
+        if (n > std::numeric_limits<size_t>::max() / elem_size - PageSize) {
+            return n;
+        }
+        const size_t bytes = n * elem_size;
+        if (bytes <= PageSize) {
+            return n;
+        }
+        return ((bytes + PageSize - 1) & ~(PageSize - 1)) / elem_size;
+    }
+};
+
+// Тег конструкторов, создающих элементы инициализацией по умолчанию: тривиальные типы
+// не обнуляются, и буфер можно сразу заполнить, например, из read() или декодера
+struct ForOverwriteTag {
+    explicit ForOverwriteTag() = default;
+};
+
+inline constexpr ForOverwriteTag for_overwrite{};
+
+// Буфер, переданный из Vector::Release: size созданных элементов в памяти на capacity элементов
 template <typename T>
+struct VectorBuffer {
+    T* ptr;
+    size_t size;
+    size_t capacity;
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth, typename Stats = NoStats>
 class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Memory = RawMemory<T, Alloc, Stats>;
+
 public:
+    using value_type = T;
+    using allocator_type = Alloc;
 
     using iterator = T*;
     using const_iterator = const T*;
@@ -124,28 +565,85 @@ public:
 
     Vector() = default;
 
+    explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc) {}
+
     //конструктор
-     explicit Vector(size_t size)
-        : data_(size)
+     explicit Vector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
         , size_(size)  
     {
         std::uninitialized_value_construct_n(data_.GetAddress(), size);
     }
 
+    // конструктор без инициализации значением: элементы тривиальных типов остаются неинициализированными
+    Vector(size_t size, ForOverwriteTag, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size)
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+    }
+
+    // конструктор, создающий элементы частями по политике выполнения, например Vector<T> v(n, parallel).
+    // Если конструктор элемента выбрасывает исключение, уже созданные элементы всех частей разрушаются
+    template <typename Policy, typename = detail::RequireExecutionPolicy<Policy>>
+    Vector(size_t size, const Policy& policy, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+    {
+        T* data = data_.GetAddress();
+        policy.ForEachChunk(
+            size, [data](size_t begin, size_t end) { std::uninitialized_value_construct(data + begin, data + end); },
+            [data](size_t begin, size_t end) { std::destroy(data + begin, data + end); });
+        size_ = size;
+    }
+
+    // конструктор из диапазона: для однопроходных итераторов элементы добавляются по одному,
+    // иначе память выделяется один раз под весь диапазон
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : Vector(alloc)
+    {
+        Append(first, last);
+    }
+
     // конструктор копирования
     Vector(const Vector& other)
-        : data_(other.size_)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {}
+
+    // конструктор копирования с явно заданным аллокатором
+    Vector(const Vector& other, const Alloc& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)  
     {    
         std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
     }
 
+    // конструктор копирования, копирующий элементы частями по политике выполнения
+    template <typename Policy, typename = detail::RequireExecutionPolicy<Policy>>
+    Vector(const Vector& other, const Policy& policy)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {
+        const T* from = other.data_.GetAddress();
+        T* to = data_.GetAddress();
+        policy.ForEachChunk(
+            other.size_,
+            [from, to](size_t begin, size_t end) { std::uninitialized_copy(from + begin, from + end, to + begin); },
+            [to](size_t begin, size_t end) { std::destroy(to + begin, to + end); });
+        size_ = other.size_;
+    }
+
     Vector(Vector&& other) noexcept
         : data_(std::move(other.data_))
         , size_(std::exchange(other.size_, 0)) {}
 
-    // Присвоение без выделения дополнительной вместимости
+    // Присвоение без выделения дополнительной вместимости: ёмкости вектора должно хватать для rhs.
+    // Аллокатор передаётся так же, как в operator=: если при propagate_on_container_copy_assignment
+    // он не равен текущему, буфер переиспользовать нельзя, и rhs копируется в буфер своего аллокатора
     void CopyAssignNoRealloc(const Vector& rhs) {
+        if (this == &rhs || PropagateCopyAllocator(rhs)) {
+            return;
+        }
+        assert(rhs.size_ <= data_.Capacity());
 
         size_t common = std::min(size_, rhs.size_);
         std::copy(rhs.data_.GetAddress(), rhs.data_ + common, data_.GetAddress());
@@ -160,10 +658,10 @@ public:
     }
 
     Vector& operator=(const Vector& rhs) {
-        if (this != &rhs) {
+        if (this != &rhs && !PropagateCopyAllocator(rhs)) {
             if (rhs.size_ > data_.Capacity()) {
-                Vector tmp(rhs);      // может выбросить исключение
-                Swap(tmp);            // безопасно, noexcept
+                Vector tmp(rhs, data_.GetAllocator());  // может выбросить исключение
+                Swap(tmp);                              // безопасно, noexcept
             } else {
                CopyAssignNoRealloc(rhs);
             }
@@ -171,19 +669,57 @@ public:
         return *this;
     }
 
-
-    Vector& operator=(Vector&& rhs) noexcept {
+    // Буфер rhs забирается целиком, если аллокатор передаётся (propagate_on_container_move_assignment)
+    // или аллокаторы равны; иначе элементы перемещаются по одному в память текущего аллокатора
+    Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
         if (this != &rhs) {
-            Swap(rhs);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.ReplaceWith(std::move(rhs.data_));
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                if (AllocatorsEqual(rhs)) {
+                    std::destroy_n(data_.GetAddress(), size_);
+                    data_ = std::move(rhs.data_);
+                    size_ = std::exchange(rhs.size_, 0);
+                } else {
+                    MoveAssignElements(rhs);
+                }
+            }
         }
         return *this;
     }
 
+    // Аллокаторы обмениваются только при propagate_on_container_swap, иначе они обязаны быть равны
     void Swap(Vector& other) noexcept{
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
+    Alloc GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Разрушает элементы и становится владельцем буфера ptr на capacity элементов, первые size из которых созданы.
+    // Буфер должен быть выделен аллокатором, равным GetAllocator(), например принятый сетевым слоем буфер
+    // передаётся вектору без копирования
+    void Adopt(T* ptr, size_t size, size_t capacity) noexcept {
+        assert(size <= capacity);
+        assert(ptr != data_.GetAddress() || ptr == nullptr);
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Adopt(ptr, capacity);
+        size_ = size;
+    }
+
+    // Передаёт буфер вместе с элементами вызывающему, оставляя вектор пустым. Вызывающий отвечает
+    // за разрушение элементов и освобождение буфера аллокатором, равным GetAllocator()
+    VectorBuffer<T> Release() noexcept {
+        const size_t capacity = data_.Capacity();
+        T* ptr = data_.Release();
+        return {ptr, std::exchange(size_, 0), capacity};
+    }
+
     ~Vector() {
         std::destroy_n(data_.GetAddress(), size_);
     }
@@ -196,48 +732,145 @@ public:
         return data_.Capacity();
     }
 
-    //В константном операторе [] используется оператор  const_cast, чтобы снять константность с ссылки на текущий объект и вызвать неконстантную версию оператора []
+    // Индекс проверяется согласно режиму ADVANCED_VECTOR_BOUNDS_CHECK
     const T& operator[](size_t index) const noexcept {
-        return const_cast<Vector&>(*this)[index];
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return data_.GetAddress()[index];
     }
 
     T& operator[](size_t index) noexcept {
-        assert(index < size_);
-        return data_[index];
+        ADVANCED_VECTOR_CHECK_BOUNDS(index < size_);
+        return data_.GetAddress()[index];
+    }
+
+    // Доступ с проверкой индекса в любой сборке
+    const T& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Vector index is out of range");
+        }
+        return data_.GetAddress()[index];
+    }
+
+    T& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Vector index is out of range");
+        }
+        return data_.GetAddress()[index];
+    }
+
+    // Доступ без проверки индекса в любой сборке, для горячих циклов с заранее проверенными границами
+    const T& UncheckedAt(size_t index) const noexcept {
+        return data_.GetAddress()[index];
+    }
+
+    T& UncheckedAt(size_t index) noexcept {
+        return data_.GetAddress()[index];
+    }
+
+    const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    T* Data() noexcept {
+        return data_.GetAddress();
     }
 
     void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        
-        // проверка на перемещяемость или на возможность копирования 
-        if constexpr (std::is_nothrow_move_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else if constexpr (std::is_copy_constructible_v<T>) {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else if constexpr (std::is_move_constructible_v<T>) {
-            // Перемещение с возможными исключениями — тоже допустимо
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        if constexpr (CAN_GROW_IN_PLACE) {
+            data_.Reallocate(new_capacity);
+            NoteReallocation(0);
+        } else {
+            Memory new_data(new_capacity, data_.GetAllocator());
+            RelocateTo(new_data);
+        }
+    }
+
+    // Reserve, переносящий элементы частями по политике выполнения. Гарантии безопасности — как у Reserve
+    template <typename Policy, typename = detail::RequireExecutionPolicy<Policy>>
+    void Reserve(size_t new_capacity, const Policy& policy) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        if constexpr (CAN_GROW_IN_PLACE) {
+            Reserve(new_capacity);
         } else {
-            static_assert(std::is_move_constructible_v<T> || std::is_copy_constructible_v<T>,
-                        "Type T must be either move or copy constructible");
+            Memory new_data(new_capacity, data_.GetAllocator());
+            detail::RelocateN(policy, data_.GetAddress(), size_, new_data.GetAddress());
+            NoteReallocation(size_);
+            data_.Swap(new_data);
         }
-            
+    }
+
+    // Разрушает все элементы, сохраняя ёмкость для повторного использования
+    void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        size_ = 0;
     }
 
-    void Resize(size_t new_size) {
-        if (new_size > size_) {
-            Reserve(new_size);
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+    // Clear, разрушающий элементы частями по политике выполнения. Деструктор Vector однопоточный,
+    // поэтому перед уничтожением огромного вектора нетривиальных типов стоит вызвать Clear(parallel)
+    template <typename Policy, typename = detail::RequireExecutionPolicy<Policy>>
+    void Clear(const Policy& policy) noexcept {
+        detail::DestroyN(policy, data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Уменьшает ёмкость до размера вектора. Элементы переносятся тем же способом, что и в Reserve;
+    // если перенос выбрасывает исключение, вектор остаётся неизменным
+    void ShrinkToFit() {
+        if (data_.Capacity() == size_) {
+            return;
         }
-        else {
-            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        if (size_ == 0) {
+            Memory empty(data_.GetAllocator());
+            data_.Swap(empty);
+            return;
+        }
+        if constexpr (CAN_GROW_IN_PLACE) {
+            data_.Reallocate(size_);
+            NoteReallocation(0);
+        } else {
+            Memory new_data(size_, data_.GetAllocator());
+            if (new_data.Capacity() >= data_.Capacity()) {
+                return;  // аллокатор не может выделить блок меньшего размера
+            }
+            RelocateTo(new_data);
         }
-        size_ = new_size;
+    }
+
+    // Вызывает ShrinkToFit, если ёмкость превышает размер более чем в ratio раз, и сообщает, была ли освобождена память.
+    // Позволяет вернуть память после всплеска, не теряя переиспользования буфера в установившемся режиме
+    bool ShrinkIfWasted(double ratio) {
+        assert(ratio >= 1.0);
+        if (static_cast<double>(data_.Capacity()) <= static_cast<double>(size_) * ratio) {
+            return false;
+        }
+        const size_t old_capacity = data_.Capacity();
+        ShrinkToFit();
+        return data_.Capacity() < old_capacity;
+    }
+
+    void Resize(size_t new_size) {
+        ResizeWith(new_size, [](T* dst, size_t n) { std::uninitialized_value_construct_n(dst, n); });
+    }
+
+    // Как Resize, но новые элементы создаются инициализацией по умолчанию: тривиальные типы не обнуляются
+    void ResizeDefaultInit(size_t new_size) {
+        ResizeWith(new_size, [](T* dst, size_t n) { std::uninitialized_default_construct_n(dst, n); });
+    }
+
+    // Аналог basic_string::resize_and_overwrite: вектор расширяется до new_size без обнуления новых элементов,
+    // затем op(data, new_size) заполняет буфер и возвращает итоговый размер (не больше new_size).
+    // Если op выбрасывает исключение, вектор остаётся размера new_size с текущим содержимым буфера
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t new_size, Operation op) {
+        ResizeDefaultInit(new_size);
+        const size_t result_size = std::move(op)(data_.GetAddress(), new_size);
+        assert(result_size <= new_size);
+        Resize(result_size);
     }
 
     void PushBack(const T& value) {
@@ -259,23 +892,25 @@ public:
     template <typename... Args>
     T& EmplaceBack(Args&&... args){
         if (size_ == Capacity()) {
+            const size_t new_capacity = NextCapacity(size_ + 1);
 
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data + size_) T(std::forward<Args>(args)...);
-
-            try {
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                        std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());   
-                }
-                else {
-                    std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            if constexpr (CAN_GROW_IN_PLACE) {
+                // args могут ссылаться на элемент вектора, поэтому объект создаётся до перевыделения буфера,
+                // а затем переносится на место побайтово
+                alignas(T) unsigned char slot[sizeof(T)];
+                T* elem = new (slot) T(std::forward<Args>(args)...);
+                try {
+                    data_.Reallocate(new_capacity);
+                    NoteReallocation(0);
+                } catch (...) {
+                    std::destroy_at(elem);
+                    throw;
                 }
-            } catch (...) {
-                std::destroy_at(new_data + size_);
-                throw;
-            }   
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
+                std::memcpy(static_cast<void*>(data_ + size_), static_cast<const void*>(slot), sizeof(T));
+            } else {
+                Memory new_data(new_capacity, data_.GetAllocator());
+                RelocateTo(new_data, size_, 1, [&](T* dst) { new (dst) T(std::forward<Args>(args)...); });
+            }
         }
         else{
             new (data_ + size_) T(std::forward<Args>(args)...);
@@ -285,87 +920,551 @@ public:
         return data_[size_ - 1];
     }
 
+    // Вставка в позицию end() выполняется через EmplaceBack. Иначе при наличии места хвост сдвигается
+    // один раз и элемент создаётся прямо на освободившемся месте (см. detail::EmplaceInGap)
     template <typename... Args>
     iterator Emplace(const_iterator pos, Args&&... args) {
-        assert(pos >= begin() && pos < end());  // Убедимся, что позиция корректна
-        size_t index = pos - begin();  // Индекс позиции вставки
+        assert(pos >= begin() && pos <= end());  // Убедимся, что позиция корректна
+        const size_t index = pos - begin();  // Индекс позиции вставки
 
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return begin() + index;
+        }
         if (size_ == Capacity()) {
-            // --- Случай 1: требуется перевыделение памяти ---
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            T* new_pos = new_data.GetAddress() + index;
+            // Новый элемент создаётся в новом буфере до переноса старых, поэтому args могут ссылаться на элементы вектора
+            Memory new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+            RelocateTo(new_data, index, 1, [&](T* dst) { new (dst) T(std::forward<Args>(args)...); });
+        } else {
+            detail::EmplaceInGap(data_.GetAddress(), size_, index, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return begin() + index;
+    }
 
-            try {
-                // Копируем все элементы до позиции вставки
-                std::uninitialized_move_n(data_.GetAddress(), index, new_data.GetAddress());
+    iterator Insert(const_iterator pos, const T& value){
+        return Emplace(pos, value);  // копируем value
+    }
 
-                // Вставляем новый элемент на нужную позицию
-                new (new_pos) T(std::forward<Args>(args)...);
+    iterator Insert(const_iterator pos, T&& value){
+        return Emplace(pos, std::move(value));  // перемещаем value
+    }
+
+    // Вставляет count копий value перед pos. Память выделяется не более одного раза, хвост сдвигается один раз
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = pos - begin();
+        auto fill = [count](const T& src) {
+            return [&src, count](T* dst, size_t assigned) {
+                std::fill_n(dst, assigned, src);
+                std::uninitialized_fill_n(dst + assigned, count - assigned, src);
+            };
+        };
+        if (Contains(&value)) {
+            // value будет сдвинут вместе с хвостом, поэтому вставляется его копия
+            T tmp(value);
+            return InsertWith(index, count, fill(tmp));
+        }
+        return InsertWith(index, count, fill(value));
+    }
 
-                // Копируем все элементы после позиции вставки
-                std::uninitialized_move_n(data_.GetAddress() + index, size_ - index, new_pos + 1);
+    // Вставляет элементы диапазона [first, last) перед pos. Для многопроходных итераторов
+    // память выделяется не более одного раза, а хвост сдвигается один раз.
+    // Возвращает итератор на первый вставленный элемент
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = pos - begin();
+
+        if constexpr (detail::IsForwardIteratorV<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            // Диапазон из самого вектора сдвинулся бы вместе с хвостом, поэтому без перевыделения
+            // вставляется его временная копия
+            if (count != 0 && count <= Capacity() - size_ && MayAlias(first, count)) {
+                Vector tmp(first, last, data_.GetAllocator());
+                return Insert(pos, std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+            }
+            return InsertWith(index, count, [&](T* dst, size_t assigned) {
+                const InputIt mid = std::next(first, assigned);
+                std::copy(first, mid, dst);
+                std::uninitialized_copy(mid, last, dst + assigned);
+            });
+        } else {
+            // Длина однопроходного диапазона заранее неизвестна: элементы добавляются в конец и
+            // затем одним поворотом переносятся на место
+            const size_t old_size = size_;
+            try {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
             } catch (...) {
-                // Если что-то пошло не так — уничтожаем всё скопированное
-                std::destroy_n(new_data.GetAddress(), index);
+                std::destroy_n(data_ + old_size, size_ - old_size);
+                size_ = old_size;
                 throw;
             }
-
-            // Удаляем старые объекты и меняем буфер
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-            ++size_;
+            std::rotate(begin() + index, begin() + old_size, end());
             return begin() + index;
-        } else {
-            // --- Случай 2: памяти хватает, вставка "на месте" ---
+        }
+    }
 
-            T tmp(std::forward<Args>(args)...);
+    // Добавляет элементы диапазона [first, last) в конец вектора
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
 
-            // Если size_ != 0, то можно сдвигать
-            if (size_ != 0) {
-                // Конструируем копию последнего элемента
-                new (data_ + size_) T(std::move(data_[size_ - 1]));
+    // Пакетное добавление в конец. Элементы создаются прямо в зарезервированном хвосте буфера, а размер
+    // вектора обновляется один раз в Commit, поэтому цикл записи не сохраняет размер на каждой итерации
+    // и может быть векторизован. Acquire(n) выдаёт сырую память под n элементов: в неё можно писать
+    // напрямую, после чего Produced(n) отмечает их созданными. При нехватке места буфер растёт по политике
+    // роста вместе с ещё не зафиксированными элементами. Всё, что не зафиксировано Commit, разрушается
+    // в Rollback или в деструкторе, в том числе при исключении. Пока AppendSink жив, вектор нельзя
+    // использовать иначе как через него
+    class AppendSink {
+    public:
+        // Итератор вывода для стандартных алгоритмов: присваивание добавляет элемент через EmplaceBack
+        class Iterator {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            explicit Iterator(AppendSink& sink) noexcept
+                : sink_(&sink) {
+            }
 
-                try {
-                    // Сдвигаем диапазон [index, size_ - 1] вправо на 1
-                    std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
-                    // Вставляем временный объект
-                    data_[index] = std::move(tmp);
-                } catch (...) {
-                    std::destroy_at(data_ + size_);
-                    throw;
-                }
+            Iterator& operator=(const T& value) {
+                sink_->EmplaceBack(value);
+                return *this;
+            }
+
+            Iterator& operator=(T&& value) {
+                sink_->EmplaceBack(std::move(value));
+                return *this;
             }
-            else{ // Если вектор пуст создаём новый объект "на месте"
-                new (data_ + index) T(std::forward<Args>(args)...);
+
+            Iterator& operator*() noexcept {
+                return *this;
             }
 
-            ++size_;
-            return begin() + index;
+            Iterator& operator++() noexcept {
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                return *this;
+            }
+
+        private:
+            AppendSink* sink_;
+        };
+
+        AppendSink(const AppendSink&) = delete;
+        AppendSink& operator=(const AppendSink&) = delete;
+
+        // Перемещённый приёмник не связан с вектором: Pending возвращает 0, Commit и Rollback ничего не делают,
+        // а добавлять через него нельзя
+        AppendSink(AppendSink&& other) noexcept
+            : vector_(std::exchange(other.vector_, nullptr))
+            , cursor_(std::exchange(other.cursor_, nullptr))
+            , limit_(std::exchange(other.limit_, nullptr)) {
         }
-    }
 
-    iterator Insert(const_iterator pos, const T& value){
-        return Emplace(pos, value);  // копируем value
+        ~AppendSink() {
+            Rollback();
+        }
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args) {
+            assert(vector_ != nullptr);
+            if (cursor_ == limit_) {
+                Grow(1);
+            }
+            T* item = new (cursor_) T(std::forward<Args>(args)...);
+            ++cursor_;
+            return *item;
+        }
+
+        void PushBack(const T& value) {
+            EmplaceBack(value);
+        }
+
+        void PushBack(T&& value) {
+            EmplaceBack(std::move(value));
+        }
+
+        // Неинициализированная память под count элементов сразу за добавленными
+        T* Acquire(size_t count) {
+            assert(vector_ != nullptr);
+            if (count > static_cast<size_t>(limit_ - cursor_)) {
+                Grow(count);
+            }
+            return cursor_;
+        }
+
+        // Отмечает созданными count элементов в памяти, полученной от Acquire
+        void Produced(size_t count) noexcept {
+            assert(count <= static_cast<size_t>(limit_ - cursor_));
+            cursor_ += count;
+        }
+
+        Iterator Inserter() noexcept {
+            return Iterator(*this);
+        }
+
+        // Число добавленных, но ещё не зафиксированных элементов
+        size_t Pending() const noexcept {
+            if (vector_ == nullptr) {
+                return 0;
+            }
+            return cursor_ - vector_->end();
+        }
+
+        // Включает добавленные элементы в размер вектора
+        void Commit() noexcept {
+            if (vector_ != nullptr) {
+                vector_->size_ = cursor_ - vector_->begin();
+            }
+        }
+
+        // Разрушает элементы, добавленные после последнего Commit
+        void Rollback() noexcept {
+            if (vector_ != nullptr) {
+                T* committed_end = vector_->end();
+                std::destroy(committed_end, cursor_);
+                cursor_ = committed_end;
+            }
+        }
+
+    private:
+        friend class Vector;
+
+        explicit AppendSink(Vector& vector) noexcept
+            : vector_(&vector)
+            , cursor_(vector.end())
+            , limit_(vector.begin() + vector.Capacity()) {
+        }
+
+        // Расширяет буфер так, чтобы после добавленных элементов поместилось ещё count.
+        // Незафиксированные элементы на время переноса включаются в размер вектора
+        void Grow(size_t count) {
+            Vector& vector = *vector_;
+            const size_t committed = vector.size_;
+            const size_t produced = cursor_ - vector.begin();
+            vector.size_ = produced;
+            try {
+                vector.Reserve(vector.NextCapacity(produced + count));
+            } catch (...) {
+                vector.size_ = committed;
+                throw;
+            }
+            vector.size_ = committed;
+            cursor_ = vector.begin() + produced;
+            limit_ = vector.begin() + vector.Capacity();
+        }
+
+        Vector* vector_;
+        T* cursor_;
+        T* limit_;
+    };
+
+    // Начинает пакетное добавление, заранее резервируя место под expected элементов
+    AppendSink BackInserter(size_t expected = 0) {
+        if (expected > Capacity() - size_) {
+            Reserve(NextCapacity(size_ + expected));
+        }
+        return AppendSink(*this);
     }
 
-    iterator Insert(const_iterator pos, T&& value){
-        return Emplace(pos, std::move(value));  // перемещаем value
+    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/{
+        assert(pos >= begin() && pos < end());  // Убедимся, что позиция корректна
+        return Erase(pos, pos + 1);
     }
 
+    // Удаляет элементы [first, last) одним сдвигом хвоста. Тривиально перемещаемые элементы
+    // разрушаются и хвост переносится memmove, остальные сдвигаются перемещающим присваиванием
+    iterator Erase(const_iterator first, const_iterator last) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/{
+        assert(first >= begin() && first <= last && last <= end());  // Убедимся, что диапазон корректен
 
-    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/{
+        iterator nonconst_first = const_cast<iterator>(first);
+        iterator nonconst_last = const_cast<iterator>(last);
+        const size_t count = last - first;
+        if (count == 0) {
+            return nonconst_first;
+        }
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            std::destroy(nonconst_first, nonconst_last);
+            std::memmove(static_cast<void*>(nonconst_first), static_cast<const void*>(nonconst_last),
+                         (end() - nonconst_last) * sizeof(T));
+        } else {
+            std::move(nonconst_last, end(), nonconst_first);  // Сдвигаем элементы влево
+            std::destroy_n(end() - count, count);              // Уничтожаем освободившийся хвост
+        }
+        size_ -= count;
+
+        return nonconst_first;
+    }
+
+    // Удаляет элемент за O(1), перенося на его место последний элемент. Порядок элементов не сохраняется.
+    // Возвращает итератор на элемент, занявший позицию pos
+    iterator EraseUnordered(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/{
         assert(pos >= begin() && pos < end());  // Убедимся, что позиция корректна
 
         iterator nonconst_pos = const_cast<iterator>(pos);
-        std::move(nonconst_pos + 1, end(), nonconst_pos);  // Сдвигаем элементы влево
-        std::destroy_at(data_ + --size_);                  // Уничтожаем последний элемент
+        T* last = data_ + size_ - 1;
+        if (nonconst_pos != last) {
+            if constexpr (IsTriviallyRelocatableV<T>) {
+                std::destroy_at(nonconst_pos);
+                std::memcpy(static_cast<void*>(nonconst_pos), static_cast<const void*>(last), sizeof(T));
+                --size_;
+                return nonconst_pos;
+            } else {
+                *nonconst_pos = std::move(*last);
+            }
+        }
+        std::destroy_at(last);
+        --size_;
 
         return nonconst_pos;
     }
     
 
 private:
-    
-    RawMemory<T> data_;
+    // Буфер тривиально перемещаемых элементов можно расширять на месте, если аллокатор это умеет
+    static constexpr bool CAN_GROW_IN_PLACE = IsTriviallyRelocatableV<T> && HasReallocateV<Alloc>;
+
+    // Ёмкость, до которой растёт буфер, чтобы вместить required элементов, согласно политике роста
+    size_t NextCapacity(size_t required) const {
+        const size_t max_size = AllocTraits::max_size(data_.GetAllocator());
+        if (required > max_size) {
+            throw std::length_error("Vector is too long");
+        }
+        return std::min(max_size, Growth::NextCapacity(data_.Capacity(), required, sizeof(T)));
+    }
+
+    // Изменяет размер вектора; construct(dst, n) создаёт n новых элементов в неинициализированной памяти dst
+    template <typename Construct>
+    void ResizeWith(size_t new_size, Construct construct) {
+        if (new_size > size_) {
+            if (new_size > data_.Capacity()) {
+                Reserve(NextCapacity(new_size));
+            }
+            construct(data_.GetAddress() + size_, new_size - size_);
+        }
+        else {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        }
+        size_ = new_size;
+    }
+
+    // Единственное место, где элементы переезжают в новый буфер new_data: Reserve, ShrinkToFit и рост
+    // в EmplaceBack, Emplace и Insert. Сначала construct(dst) создаёт count новых элементов в пропуске перед
+    // позицией index, затем старые элементы переносятся вокруг пропуска так же, как в detail::TransferN:
+    // перемещением, если оно не бросает исключений, иначе копированием. Старый буфер не меняется, пока новый
+    // не готов, поэтому construct может ссылаться на элементы вектора, а при исключении вектор остаётся
+    // неизменным (кроме некопируемых типов с бросающим перемещением). Размер вектора обновляет вызывающий
+    template <typename Construct>
+    void RelocateTo(Memory& new_data, size_t index, size_t count, Construct construct) {
+        T* gap = new_data.GetAddress() + index;
+        construct(gap);
+        try {
+            detail::RelocateAroundGap(data_.GetAddress(), size_, index, count, new_data.GetAddress());
+        } catch (...) {
+            std::destroy_n(gap, count);
+            throw;
+        }
+        NoteReallocation(size_);
+        data_.Swap(new_data);
+    }
+
+    void RelocateTo(Memory& new_data) {
+        RelocateTo(new_data, size_, 0, [](T*) noexcept {});
+    }
+
+    // Сообщает политике статистики о замене буфера с элементами, relocated из которых перенесены поэлементно
+    void NoteReallocation(size_t relocated) const noexcept {
+        if (size_ != 0) {
+            Stats::OnReallocate(relocated);
+        }
+    }
+
+    // Указатель ссылается на элемент вектора
+    bool Contains(const T* ptr) const noexcept {
+        return std::less_equal<const T*>()(begin(), ptr) && std::less<const T*>()(ptr, end());
+    }
+
+    // Непустой диапазон из count элементов, начиная с first, может ссылаться на элементы вектора: его первый
+    // или последний элемент лежит в буфере. Ссылки на объекты другого типа не могут указывать в буфер,
+    // а итератор, разыменование которого даёт временный объект, может вычислять его из элементов вектора,
+    // поэтому такой диапазон считается пересекающимся
+    template <typename ForwardIt>
+    bool MayAlias(ForwardIt first, size_t count) const {
+        using Reference = typename std::iterator_traits<ForwardIt>::reference;
+        if constexpr (!std::is_reference_v<Reference>) {
+            return true;
+        } else if constexpr (!std::is_same_v<std::remove_cv_t<std::remove_reference_t<Reference>>, T>) {
+            return false;
+        } else {
+            const auto address = [](ForwardIt it) -> const T* {
+                auto&& ref = *it;
+                return std::addressof(ref);
+            };
+            return Contains(address(first)) || Contains(address(std::next(first, count - 1)));
+        }
+    }
+
+    // Вставляет count элементов перед позицией index. construct(dst, assigned) присваивает новые значения
+    // первым assigned живым объектам dst и создаёт остальные в неинициализированной памяти, а при исключении
+    // сам разрушает уже созданные. При нехватке места новые элементы создаются в новом буфере до переноса
+    // старых, поэтому construct может ссылаться на элементы вектора; иначе он не должен на них ссылаться.
+    // Хвост сдвигается один раз: тривиально перемещаемый — одним memmove, остальные — переносом последних
+    // min(count, size - index) элементов за конец и move_backward оставшихся. Если construct выбрасывает
+    // исключение, для тривиально перемещаемых и nothrow-перемещаемых типов вектор остаётся неизменным,
+    // для остальных действует базовая гарантия с прежним размером
+    template <typename Construct>
+    iterator InsertWith(size_t index, size_t count, Construct construct) {
+        if (count == 0) {
+            return begin() + index;
+        }
+        T* pos = data_ + index;
+        if (count > Capacity() - size_) {
+            Memory new_data(NextCapacity(size_ + count), data_.GetAllocator());
+            RelocateTo(new_data, index, count, [&](T* dst) { construct(dst, 0); });
+        } else if constexpr (IsTriviallyRelocatableV<T>) {
+            const size_t tail_bytes = (size_ - index) * sizeof(T);
+            std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), tail_bytes);
+            try {
+                construct(pos, 0);
+            } catch (...) {
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), tail_bytes);
+                throw;
+            }
+        } else {
+            // Элементы, переехавшие в неинициализированную память за концом, начинаются с moved_out
+            T* end = data_ + size_;
+            const size_t live_gap = std::min(count, size_ - index);
+            T* moved_out = end + count - live_gap;
+            detail::TransferN(end - live_gap, live_gap, moved_out);
+            try {
+                std::move_backward(pos, end - live_gap, moved_out);
+                construct(pos, live_gap);
+            } catch (...) {
+                if constexpr (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+                    std::move(pos + count, end + count, pos);
+                }
+                std::destroy_n(moved_out, live_gap);
+                throw;
+            }
+        }
+        size_ += count;
+        return begin() + index;
+    }
+
+    // При propagate_on_container_copy_assignment забирает аллокатор rhs. Новый аллокатор не сможет освободить
+    // текущий буфер, поэтому при неравных аллокаторах rhs сразу копируется в новый буфер; возвращает,
+    // выполнено ли присваивание целиком
+    bool PropagateCopyAllocator(const Vector& rhs) {
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (!AllocatorsEqual(rhs)) {
+                Vector tmp(rhs, rhs.data_.GetAllocator());  // может выбросить исключение
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.ReplaceWith(std::move(tmp.data_));
+                size_ = std::exchange(tmp.size_, 0);
+                return true;
+            }
+            data_.GetAllocator() = rhs.data_.GetAllocator();
+        }
+        return false;
+    }
+
+    bool AllocatorsEqual(const Vector& other) const noexcept {
+        if constexpr (AllocTraits::is_always_equal::value) {
+            return true;
+        } else {
+            return data_.GetAllocator() == other.data_.GetAllocator();
+        }
+    }
+
+    // Перемещающее присваивание при неравных аллокаторах: буфер rhs забрать нельзя,
+    // поэтому элементы перемещаются в собственную память (с перевыделением при необходимости)
+    void MoveAssignElements(Vector& rhs) {
+        if (rhs.size_ > data_.Capacity()) {
+            Memory new_data(rhs.size_, data_.GetAllocator());
+            std::uninitialized_move_n(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+        } else {
+            size_t common = std::min(size_, rhs.size_);
+            std::move(rhs.data_.GetAddress(), rhs.data_ + common, data_.GetAddress());
+            if (size_ > rhs.size_) {
+                std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_);
+            } else {
+                std::uninitialized_move_n(rhs.data_.GetAddress() + size_, rhs.size_ - size_, data_.GetAddress() + size_);
+            }
+        }
+        size_ = rhs.size_;
+        std::destroy_n(rhs.data_.GetAddress(), rhs.size_);
+        rhs.size_ = 0;
+    }
+
+    Memory data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+};
+
+// Удаляет все элементы, удовлетворяющие pred, за один проход уплотнения и одно разрушение хвоста.
+// Возвращает количество удалённых элементов
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Pred>
+size_t erase_if(Vector<T, Alloc, Growth, Stats>& vector, Pred pred) {
+    auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    const size_t count = vector.end() - new_end;
+    vector.Erase(new_end, vector.end());
+    return count;
+}
+
+// Удаляет все элементы, равные value. Возвращает количество удалённых элементов
+template <typename T, typename Alloc, typename Growth, typename Stats, typename U>
+size_t erase(Vector<T, Alloc, Growth, Stats>& vector, const U& value) {
+    return erase_if(vector, [&value](const T& elem) { return elem == value; });
+}
+
+// Для типов с уникальным объектным представлением (целые, указатели, перечисления) равенство
+// значений совпадает с побайтовым, и сравнение выполняется через memcmp
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator==(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (std::has_unique_object_representations_v<T>) {
+        return lhs.Size() == 0 || std::memcmp(lhs.begin(), rhs.begin(), lhs.Size() * sizeof(T)) == 0;
+    } else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator!=(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    return !(lhs == rhs);
+}
+
+// Лексикографическое сравнение, как у std::vector
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator<=(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool operator>=(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,354 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Пакетные алгоритмы над непрерывным буфером Vector: Fill, Find, Count, Sum, MinMax, Equal.
+// Для арифметических типов на GCC/Clang используются векторные расширения компилятора:
+// на x86-64 ширина регистра выбирается во время выполнения (SSE2, AVX2 или AVX-512),
+// на AArch64 базовый вариант компилируется в инструкции NEON.
+// Для остальных типов и компиляторов используются скалярные алгоритмы стандартной библиотеки
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ADVANCED_VECTOR_SIMD 1
+#if defined(__x86_64__) || defined(__i386__)
+#define ADVANCED_VECTOR_SIMD_X86 1
+#endif
+#endif
+
+namespace detail::simd {
+
+// Набор инструкций, для которого выбираются ядра
+enum class SimdLevel { BASELINE, AVX2, AVX512 };
+
+inline SimdLevel DetectSimdLevel() noexcept {
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::BASELINE;
+    }();
+    return level;
+#else
+    return SimdLevel::BASELINE;
+#endif
+}
+
+// Типы, для которых есть векторные ядра
+template <typename T>
+inline constexpr bool IsSimdTypeV =
+#if defined(ADVANCED_VECTOR_SIMD)
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>;
+#else
+    false;
+#endif
+
+template <typename T>
+struct KernelTable {
+    void (*fill)(T* data, size_t n, T value);
+    size_t (*find)(const T* data, size_t n, T value);
+    size_t (*count)(const T* data, size_t n, T value);
+    T (*sum)(const T* data, size_t n);
+    void (*min_max)(const T* data, size_t n, T& min, T& max);
+    bool (*equal)(const T* lhs, const T* rhs, size_t n);
+};
+
+#if defined(ADVANCED_VECTOR_SIMD)
+
+#define ADVANCED_VECTOR_INLINE __attribute__((always_inline)) inline
+
+// Вспомогательные функции с векторными аргументами всегда встраиваются, поэтому
+// предупреждение о смене ABI для широких векторов к ним не относится
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// Ядра для регистра шириной Width байт. Тела встраиваются в обёртки с атрибутом target,
+// поэтому один и тот же код компилируется под каждый набор инструкций
+template <typename T, size_t Width>
+struct Kernels {
+    using Vec [[gnu::vector_size(Width)]] = T;
+    using Mask = decltype(Vec{} == Vec{});
+
+    static constexpr size_t LANES = Width / sizeof(T);
+
+    ADVANCED_VECTOR_INLINE static Vec Load(const T* p) noexcept {
+        Vec v;
+        std::memcpy(&v, p, Width);
+        return v;
+    }
+
+    ADVANCED_VECTOR_INLINE static Vec Broadcast(T value) noexcept {
+        Vec v;
+        for (size_t i = 0; i < LANES; ++i) {
+            v[i] = value;
+        }
+        return v;
+    }
+
+    ADVANCED_VECTOR_INLINE static bool Any(const Mask& m) noexcept {
+        uint64_t words[Width / 8];
+        std::memcpy(words, &m, Width);
+        uint64_t result = 0;
+        for (size_t i = 0; i < Width / 8; ++i) {
+            result |= words[i];
+        }
+        return result != 0;
+    }
+
+    ADVANCED_VECTOR_INLINE static void Fill(T* data, size_t n, T value) noexcept {
+        const Vec v = Broadcast(value);
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            std::memcpy(data + i, &v, Width);
+        }
+        const size_t tail = n - i;
+        for (size_t j = 0; j < tail; ++j) {
+            data[i + j] = value;
+        }
+    }
+
+    ADVANCED_VECTOR_INLINE static size_t Find(const T* data, size_t n, T value) noexcept {
+        const Vec needle = Broadcast(value);
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            if (Any(Load(data + i) == needle)) {
+                break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    ADVANCED_VECTOR_INLINE static size_t Count(const T* data, size_t n, T value) noexcept {
+        // Совпадения накапливаются в дорожках маски (-1 за совпадение); чтобы узкие дорожки
+        // не переполнились, накопитель сбрасывается в скалярный счётчик каждые 127 итераций
+        const Vec needle = Broadcast(value);
+        size_t result = 0;
+        size_t i = 0;
+        while (i + LANES <= n) {
+            Mask acc{};
+            for (size_t step = 0; step < 127 && i + LANES <= n; ++step, i += LANES) {
+                acc += Load(data + i) == needle;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                result += static_cast<size_t>(-static_cast<int64_t>(acc[lane]));
+            }
+        }
+        for (; i < n; ++i) {
+            result += data[i] == value;
+        }
+        return result;
+    }
+
+    ADVANCED_VECTOR_INLINE static T Sum(const T* data, size_t n) noexcept {
+        Vec acc{};
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            acc += Load(data + i);
+        }
+        T result{};
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            result += acc[lane];
+        }
+        const size_t tail = n - i;
+        for (size_t j = 0; j < tail; ++j) {
+            result += data[i + j];
+        }
+        return result;
+    }
+
+    ADVANCED_VECTOR_INLINE static void MinMax(const T* data, size_t n, T& min, T& max) noexcept {
+        min = data[0];
+        max = data[0];
+        size_t i = 0;
+        if (n >= LANES) {
+            Vec vmin = Load(data);
+            Vec vmax = vmin;
+            for (i = LANES; i + LANES <= n; i += LANES) {
+                const Vec x = Load(data + i);
+                vmin = x < vmin ? x : vmin;
+                vmax = x > vmax ? x : vmax;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                min = vmin[lane] < min ? vmin[lane] : min;
+                max = vmax[lane] > max ? vmax[lane] : max;
+            }
+        }
+        const size_t tail = n - i;
+        for (size_t j = 0; j < tail; ++j) {
+            const T x = data[i + j];
+            min = x < min ? x : min;
+            max = x > max ? x : max;
+        }
+    }
+
+    ADVANCED_VECTOR_INLINE static bool Equal(const T* lhs, const T* rhs, size_t n) noexcept {
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            if (Any(Load(lhs + i) != Load(rhs + i))) {
+                return false;
+            }
+        }
+        for (; i < n; ++i) {
+            if (!(lhs[i] == rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Объявляет набор ядер с атрибутом target и фабрику таблицы функций для него
+#define ADVANCED_VECTOR_DEFINE_KERNELS(NAME, TARGET, WIDTH)                                              \
+    template <typename T>                                                                                 \
+    struct NAME {                                                                                         \
+        using K = Kernels<T, WIDTH>;                                                                      \
+        TARGET static void Fill(T* data, size_t n, T value) { K::Fill(data, n, value); }                  \
+        TARGET static size_t Find(const T* data, size_t n, T value) { return K::Find(data, n, value); }   \
+        TARGET static size_t Count(const T* data, size_t n, T value) { return K::Count(data, n, value); } \
+        TARGET static T Sum(const T* data, size_t n) { return K::Sum(data, n); }                          \
+        TARGET static void MinMax(const T* data, size_t n, T& min, T& max) { K::MinMax(data, n, min, max); } \
+        TARGET static bool Equal(const T* lhs, const T* rhs, size_t n) { return K::Equal(lhs, rhs, n); }  \
+        static KernelTable<T> Table() noexcept {                                                          \
+            return {&Fill, &Find, &Count, &Sum, &MinMax, &Equal};                                         \
+        }                                                                                                 \
+    }
+
+ADVANCED_VECTOR_DEFINE_KERNELS(BaselineKernels, , 16);
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+ADVANCED_VECTOR_DEFINE_KERNELS(Avx2Kernels, __attribute__((target("avx2"))), 32);
+ADVANCED_VECTOR_DEFINE_KERNELS(Avx512Kernels, __attribute__((target("avx512f,avx512bw"))), 64);
+#endif
+
+#pragma GCC diagnostic pop
+
+#undef ADVANCED_VECTOR_DEFINE_KERNELS
+#undef ADVANCED_VECTOR_INLINE
+
+// Таблица ядер для T выбирается один раз при первом обращении
+template <typename T>
+const KernelTable<T>& GetKernels() noexcept {
+    static const KernelTable<T> table = [] {
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+        switch (DetectSimdLevel()) {
+            case SimdLevel::AVX512:
+                return Avx512Kernels<T>::Table();
+            case SimdLevel::AVX2:
+                return Avx2Kernels<T>::Table();
+            default:
+                break;
+        }
+#endif
+        return BaselineKernels<T>::Table();
+    }();
+    return table;
+}
+
+#endif  // ADVANCED_VECTOR_SIMD
+
+}  // namespace detail::simd
+
+namespace detail {
+
+// Параметр значения не участвует в выводе T, поэтому Fill(doubles, 0) приводит 0 к типу элементов вектора
+#if __cplusplus >= 202002L
+template <typename T>
+using NonDeducedT = std::type_identity_t<T>;
+#else
+template <typename T>
+struct TypeIdentity {
+    using type = T;
+};
+
+template <typename T>
+using NonDeducedT = typename TypeIdentity<T>::type;
+#endif
+
+}  // namespace detail
+
+// Присваивает всем элементам значение value
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void Fill(Vector<T, Alloc, Growth, Stats>& vector, const detail::NonDeducedT<T>& value) {
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        detail::simd::GetKernels<T>().fill(vector.begin(), vector.Size(), value);
+    } else {
+        std::fill(vector.begin(), vector.end(), value);
+    }
+}
+
+// Возвращает итератор на первый элемент, равный value, или end()
+template <typename T, typename Alloc, typename Growth, typename Stats>
+auto Find(const Vector<T, Alloc, Growth, Stats>& vector, const detail::NonDeducedT<T>& value) {
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        return vector.begin() + detail::simd::GetKernels<T>().find(vector.begin(), vector.Size(), value);
+    } else {
+        return std::find(vector.begin(), vector.end(), value);
+    }
+}
+
+// Возвращает количество элементов, равных value
+template <typename T, typename Alloc, typename Growth, typename Stats>
+size_t Count(const Vector<T, Alloc, Growth, Stats>& vector, const detail::NonDeducedT<T>& value) {
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        return detail::simd::GetKernels<T>().count(vector.begin(), vector.Size(), value);
+    } else {
+        return static_cast<size_t>(std::count(vector.begin(), vector.end(), value));
+    }
+}
+
+// Возвращает сумму элементов в типе T. Для чисел с плавающей точкой порядок сложения
+// не последовательный, поэтому результат может отличаться от std::accumulate в младших разрядах
+template <typename T, typename Alloc, typename Growth, typename Stats>
+T Sum(const Vector<T, Alloc, Growth, Stats>& vector) {
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        return detail::simd::GetKernels<T>().sum(vector.begin(), vector.Size());
+    } else {
+        T result{};
+        for (const T& value : vector) {
+            result += value;
+        }
+        return result;
+    }
+}
+
+// Возвращает наименьший и наибольший элементы непустого вектора. Результат для векторов с NaN не определён
+template <typename T, typename Alloc, typename Growth, typename Stats>
+std::pair<T, T> MinMax(const Vector<T, Alloc, Growth, Stats>& vector) {
+    assert(vector.Size() > 0);
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        std::pair<T, T> result;
+        detail::simd::GetKernels<T>().min_max(vector.begin(), vector.Size(), result.first, result.second);
+        return result;
+    } else {
+        auto [min, max] = std::minmax_element(vector.begin(), vector.end());
+        return {*min, *max};
+    }
+}
+
+// Поэлементное сравнение на равенство. В отличие от operator==, для чисел с плавающей точкой
+// используются векторные ядра (сравнение по значению: NaN не равен себе, 0.0 == -0.0)
+template <typename T, typename Alloc, typename Growth, typename Stats>
+bool Equal(const Vector<T, Alloc, Growth, Stats>& lhs, const Vector<T, Alloc, Growth, Stats>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (detail::simd::IsSimdTypeV<T>) {
+        return detail::simd::GetKernels<T>().equal(lhs.begin(), rhs.begin(), lhs.Size());
+    } else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
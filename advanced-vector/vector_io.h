@@ -0,0 +1,114 @@
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// Заголовок сериализованного Vector. Элементы записываются сразу за заголовком в представлении
+// и порядке байт текущей платформы
+struct VectorIoHeader {
+    static constexpr uint64_t MAGIC = 0x4f49434556564100;  // "\0AVVECIO"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t elem_size;
+    uint64_t size;  // число элементов
+};
+
+namespace detail {
+
+[[noreturn]] inline void ThrowIoError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), std::string("Vector I/O: ") + what);
+}
+
+// Записывает все iovcnt буферов, продолжая после частичной записи
+inline void WriteAll(int fd, iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        const ssize_t written = writev(fd, iov, iovcnt);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowIoError("writev");
+        }
+        size_t rest = static_cast<size_t>(written);
+        while (iovcnt > 0 && rest >= iov->iov_len) {
+            rest -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + rest;
+            iov->iov_len -= rest;
+        }
+    }
+}
+
+// Читает ровно size байт; конец файла до этого считается ошибкой формата
+inline void ReadAll(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = read(fd, p, size);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowIoError("read");
+        }
+        if (received == 0) {
+            throw std::runtime_error("Vector I/O: unexpected end of file");
+        }
+        p += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+}  // namespace detail
+
+// Записывает заголовок и буфер вектора одним вызовом writev
+template <typename T, typename Alloc, typename Growth, typename Stats>
+void WriteVector(int fd, const Vector<T, Alloc, Growth, Stats>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be written as bytes");
+    VectorIoHeader header{VectorIoHeader::MAGIC, VectorIoHeader::VERSION, sizeof(T), v.Size()};
+    iovec iov[2] = {{&header, sizeof(header)},
+                    {const_cast<T*>(v.begin()), v.Size() * sizeof(T)}};
+    detail::WriteAll(fd, iov, v.Size() != 0 ? 2 : 1);
+}
+
+// Проверяет заголовок, прочитанный или принятый отдельно от данных, и возвращает число элементов.
+// Сетевой слой может выделить буфер аллокатором вектора, принять в него данные и передать его в Vector::Adopt
+template <typename T>
+size_t CheckVectorHeader(const VectorIoHeader& header) {
+    if (header.magic != VectorIoHeader::MAGIC) {
+        throw std::runtime_error("Vector I/O: not a serialized Vector");
+    }
+    if (header.version != VectorIoHeader::VERSION) {
+        throw std::runtime_error("Vector I/O: unsupported format version");
+    }
+    if (header.elem_size != sizeof(T)) {
+        throw std::runtime_error("Vector I/O: element size mismatch");
+    }
+    if (header.size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::length_error("Vector I/O: vector is too long");
+    }
+    return static_cast<size_t>(header.size);
+}
+
+// Читает вектор, записанный WriteVector. Данные читаются прямо в буфер вектора без промежуточной копии
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth, typename Stats = NoStats>
+Vector<T, Alloc, Growth, Stats> ReadVector(int fd, const Alloc& alloc = Alloc()) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be read as bytes");
+    VectorIoHeader header;
+    detail::ReadAll(fd, &header, sizeof(header));
+    Vector<T, Alloc, Growth, Stats> v(CheckVectorHeader<T>(header), for_overwrite, alloc);
+    detail::ReadAll(fd, v.begin(), v.Size() * sizeof(T));
+    return v;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#include "vector.h"
+
+// Политика выполнения, распределяющая создание, копирование, перенос и разрушение элементов по потокам:
+//     Vector<std::string> names(100'000'000, parallel);
+//     Vector<std::string> copy(names, ParallelPolicy{8});
+//     names.Clear(parallel);
+// Диапазон делится на части не меньше min_chunk элементов, по одной на поток; одну из частей обрабатывает
+// вызывающий поток. Маленькие диапазоны обрабатываются в вызывающем потоке без запуска новых
+struct ParallelPolicy {
+    size_t threads = 0;           // число потоков, 0 — std::thread::hardware_concurrency()
+    size_t min_chunk = 1 << 16;   // наименьшее число элементов, ради которого стоит запускать поток
+
+    template <typename Op, typename Undo>
+    void ForEachChunk(size_t n, Op op, Undo undo) const {
+        const size_t chunks = ChunkCount(n);
+        Vector<std::exception_ptr> errors;
+        Vector<std::thread> workers;
+        bool can_run_in_parallel = chunks > 1;
+        if (can_run_in_parallel) {
+            try {
+                errors.Resize(chunks);
+                workers.Reserve(chunks - 1);
+            } catch (const std::bad_alloc&) {
+                can_run_in_parallel = false;
+            }
+        }
+        if (!can_run_in_parallel) {
+            op(size_t{0}, n);
+            return;
+        }
+
+        auto bound = [n, chunks](size_t chunk) {
+            return n / chunks * chunk + std::min(chunk, n % chunks);
+        };
+        auto run = [&op, &errors, &bound](size_t chunk) noexcept {
+            try {
+                op(bound(chunk), bound(chunk + 1));
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        };
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            try {
+                workers.EmplaceBack(run, chunk);
+            } catch (const std::system_error&) {
+                // Система не дала создать поток — часть обрабатывается в вызывающем потоке
+                run(chunk);
+            } catch (const std::bad_alloc&) {
+                // Не хватило памяти под состояние потока: запущенные потоки всё равно дожидаются ниже
+                run(chunk);
+            }
+        }
+        run(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        const auto failed = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+            return error != nullptr;
+        });
+        if (failed != errors.end()) {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                if (errors[chunk] == nullptr) {
+                    undo(bound(chunk), bound(chunk + 1));
+                }
+            }
+            std::rethrow_exception(*failed);
+        }
+    }
+
+    // Число частей, на которые делится диапазон из n элементов
+    size_t ChunkCount(size_t n) const noexcept {
+        const size_t max_threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        const size_t chunk = std::max<size_t>(min_chunk, 1);
+        return std::max<size_t>(1, std::min(max_threads, n / chunk));
+    }
+};
+
+template <>
+struct IsExecutionPolicy<ParallelPolicy> : std::true_type {};
+
+inline constexpr ParallelPolicy parallel{};
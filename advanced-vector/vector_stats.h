@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "vector.h"
+
+// Счётчики работы с памятью одной группы векторов (обычно — одного места вызова)
+struct VectorStats {
+    std::atomic<uint64_t> allocations{0};         // выделено буферов
+    std::atomic<uint64_t> bytes_allocated{0};     // суммарный объём выделенных буферов
+    std::atomic<uint64_t> reallocations{0};       // замен буфера при росте или сжатии вектора
+    std::atomic<uint64_t> elements_relocated{0};  // элементов перенесено поэлементно (без realloc/mremap)
+    std::atomic<uint64_t> peak_capacity{0};       // наибольшая ёмкость буфера в элементах
+};
+
+// Снимок счётчиков для выгрузки во внешнюю систему мониторинга
+struct VectorStatsSnapshot {
+    const char* name;
+    uint64_t allocations;
+    uint64_t bytes_allocated;
+    uint64_t reallocations;
+    uint64_t elements_relocated;
+    uint64_t peak_capacity;
+};
+
+// Глобальный реестр счётчиков. Группа регистрируется при первом использовании её политики CountingStats.
+// Реестр — односвязный список статических узлов групп, поэтому регистрация не выделяет память и не
+// блокирует: её можно выполнять из noexcept-методов политики
+class VectorStatsRegistry {
+public:
+    // Узел списка; каждая группа владеет одним статическим узлом и регистрирует его один раз
+    struct Entry {
+        const char* name;
+        const VectorStats* stats;
+        const Entry* next = nullptr;
+    };
+
+    static VectorStatsRegistry& Instance() noexcept {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    // Добавляет узел в начало списка. После публикации узел не меняется
+    void Register(Entry& entry) noexcept {
+        entry.next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(entry.next, &entry, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    // Возвращает снимок всех зарегистрированных групп, начиная с последней
+    Vector<VectorStatsSnapshot> Collect() const {
+        const Entry* const head = head_.load(std::memory_order_acquire);
+        size_t count = 0;
+        for (const Entry* entry = head; entry != nullptr; entry = entry->next) {
+            ++count;
+        }
+        Vector<VectorStatsSnapshot> result;
+        result.Reserve(count);
+        for (const Entry* entry = head; entry != nullptr; entry = entry->next) {
+            const VectorStats& stats = *entry->stats;
+            result.PushBack({entry->name,
+                             stats.allocations.load(std::memory_order_relaxed),
+                             stats.bytes_allocated.load(std::memory_order_relaxed),
+                             stats.reallocations.load(std::memory_order_relaxed),
+                             stats.elements_relocated.load(std::memory_order_relaxed),
+                             stats.peak_capacity.load(std::memory_order_relaxed)});
+        }
+        return result;
+    }
+
+private:
+    constexpr VectorStatsRegistry() noexcept = default;
+
+    std::atomic<const Entry*> head_{nullptr};
+};
+
+// Политика статистики, накапливающая счётчики в группе Tag.
+// Tag — любой тип с полем static constexpr const char* NAME, например:
+//     struct RequestIdsTag { static constexpr const char* NAME = "request_ids"; };
+//     Vector<int, std::allocator<int>, DoublingGrowth, CountingStats<RequestIdsTag>> ids;
+template <typename Tag>
+struct CountingStats {
+    static VectorStats& Get() noexcept {
+        static VectorStats& stats = Register();
+        return stats;
+    }
+
+    static void OnAllocate(size_t capacity, size_t bytes) noexcept {
+        VectorStats& stats = Get();
+        stats.allocations.fetch_add(1, std::memory_order_relaxed);
+        stats.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        uint64_t peak = stats.peak_capacity.load(std::memory_order_relaxed);
+        while (peak < capacity
+               && !stats.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnReallocate(size_t relocated) noexcept {
+        VectorStats& stats = Get();
+        stats.reallocations.fetch_add(1, std::memory_order_relaxed);
+        stats.elements_relocated.fetch_add(relocated, std::memory_order_relaxed);
+    }
+
+private:
+    static VectorStats& Register() noexcept {
+        static VectorStats stats;
+        static VectorStatsRegistry::Entry entry{Tag::NAME, &stats};
+        VectorStatsRegistry::Instance().Register(entry);
+        return stats;
+    }
+};